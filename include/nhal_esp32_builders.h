@@ -23,7 +23,6 @@
         .is_initialized = false, \
         .is_configured = false, \
         .is_driver_installed = false, \
-        .mutex = NULL, \
         .timeout_ms = 0 \
     };
 
@@ -97,7 +96,6 @@
         .actual_frequency_hz = 0, \
         .is_initialized = false, \
         .is_configured = false, \
-        .is_driver_installed = false, \
         .device_handle = NULL, \
         .mutex = NULL \
     };
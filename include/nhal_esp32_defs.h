@@ -20,10 +20,47 @@
 // ESP32 Includes ->
 #include "freertos/idf_additions.h"
 #include "driver/spi_master.h"
-#include "driver/i2c.h"
 #include "hal/uart_types.h"
 #include "esp_err.h"
 
+//==============================================================================
+// I2C BACKEND SELECTION
+//==============================================================================
+// ESP-IDF ships two mutually exclusive I2C master drivers: the legacy
+// `driver/i2c.h` (command links) and the bus/device driver from
+// `driver/i2c_master.h`. Linking both aborts at startup, so the backend is a
+// build-time choice (see NHAL_ESP32_I2C_BACKEND in CMakeLists.txt).
+
+#define NHAL_ESP32_I2C_BACKEND_LEGACY       0
+#define NHAL_ESP32_I2C_BACKEND_MASTER_BUS   1
+
+#ifndef NHAL_ESP32_I2C_BACKEND
+#define NHAL_ESP32_I2C_BACKEND NHAL_ESP32_I2C_BACKEND_MASTER_BUS
+#endif
+
+#if NHAL_ESP32_I2C_BACKEND == NHAL_ESP32_I2C_BACKEND_MASTER_BUS
+#include "driver/i2c_master.h"
+#else
+#include "driver/i2c.h"
+#endif
+
+// Number of device handles cached per I2C context (master bus backend only).
+#ifndef NHAL_ESP32_I2C_DEV_CACHE_SIZE
+#define NHAL_ESP32_I2C_DEV_CACHE_SIZE 8
+#endif
+
+// Maximum number of tasks that can wait for the same I2C bus at once.
+#ifndef NHAL_ESP32_I2C_ARB_MAX_WAITERS
+#define NHAL_ESP32_I2C_ARB_MAX_WAITERS 8
+#endif
+
+// Number of I2C request priority classes (see nhal_esp32_i2c_arbiter.h).
+#define NHAL_ESP32_I2C_PRIORITY_CLASSES 4
+
+// SPI transfer size classes kept in the statistics: <=64 B, <=128 B, ...,
+// <=16 KB and above.
+#define NHAL_ESP32_SPI_STATS_SIZE_CLASSES 10
+
 
 //==============================================================================
 // PLATFORM-SPECIFIC CONFIGURATION STRUCTURES
@@ -53,6 +90,11 @@ struct nhal_uart_impl_config{
     uint8_t intr_alloc_flags;
     uint8_t queue_size      ;
     uint8_t queue_msg_size  ;
+    uint8_t rx_flow_ctrl_thresh; // RX FIFO level that deasserts RTS, 0 for NHAL_ESP32_UART_FLOW_CTRL_THRESH
+    uint8_t rx_full_thresh  ;   // RX FIFO level that interrupts to move data, 0 for the driver default
+    uint8_t rx_timeout      ;   // Idle symbols before buffered bytes are moved, 0 for the driver default
+                                //   (the RS-485 inter-frame gap in RS-485 modes)
+    uint8_t uart_mode       ;   // uart_mode_t; UART_MODE_RS485_HALF_DUPLEX drives RTS as the transceiver DE
 } ;
 
 struct nhal_pin_impl_config{
@@ -66,6 +108,16 @@ struct nhal_spi_impl_config{
     uint8_t cs_pin          ;
     uint32_t frequency_hz   ;
     nhal_timeout_ms timeout_ms ;
+    bool use_dma            ;   // Let the bus pick a DMA channel
+    uint32_t max_transfer_sz;   // Largest transaction in bytes with DMA, 0 for the IDF default
+    uint32_t bounce_buffer_size; // DMA-capable bounce buffer for other memory, 0 for none
+    uint8_t queue_size      ;   // Driver transaction queue depth, 0 for 1
+    uint16_t polling_threshold; // Transfers up to this many bytes busy-poll, 0 to never poll
+    uint8_t data_lines      ;   // Data lines routed: 1, 2 (MOSI/MISO as D0/D1) or 4; 0 for 1
+    uint8_t quadwp_pin      ;   // D2, data_lines == 4 only
+    uint8_t quadhd_pin      ;   // D3, data_lines == 4 only
+    bool max_frequency      ;   // Ignore frequency_hz and run at the fastest clock the routing allows
+    uint8_t input_delay_ns  ;   // Device MISO valid delay after SCLK, limits full-duplex clocks
 } ;
 
 //==============================================================================
@@ -86,13 +138,77 @@ struct nhal_pin_context {
     nhal_pin_int_trigger_t interrupt_trigger;
 };
 
+struct nhal_i2c_stats {
+    uint32_t transactions;      // Completed bus transactions (any result)
+    uint32_t errors;            // Transactions that did not return NHAL_OK
+    uint64_t total_time_us;     // Time spent inside the backend, bus time included
+    uint32_t max_time_us;       // Slowest single transaction
+    uint32_t dev_cache_hits;    // Device handle reused (master bus backend)
+    uint32_t dev_cache_misses;  // Device handle created (master bus backend)
+    uint32_t link_builds;       // Command links built, heap or static (legacy backend)
+    uint32_t heap_allocations;  // Those built on the heap path, counted by the code, not measured (legacy backend)
+};
+
+struct nhal_i2c_arb_stats {
+    uint32_t acquisitions;      // Times the bus was granted to this class
+    uint32_t timeouts;          // Requests that gave up (timeout, deadline or no waiter slot)
+    uint64_t total_wait_us;     // Sum of wait times of granted requests
+    uint32_t max_wait_us;       // Longest wait of a granted request
+};
+
+struct nhal_i2c_arb_waiter {
+    SemaphoreHandle_t wake;
+    StaticSemaphore_t wake_buffer;
+    uint64_t enqueued_us;
+    uint64_t deadline_us;       // 0 when the request has no deadline
+    TaskHandle_t task;
+    UBaseType_t task_priority;  // FreeRTOS priority, lent to the owner while waiting
+    uint8_t priority;
+    bool in_use;
+    bool granted;
+};
+
+#if NHAL_ESP32_I2C_BACKEND == NHAL_ESP32_I2C_BACKEND_MASTER_BUS
+struct nhal_i2c_dev_cache_entry {
+    uint8_t address_7bit;
+    i2c_master_dev_handle_t handle;
+};
+#endif
+
 struct nhal_i2c_context {
     i2c_port_t i2c_bus_id;
     bool is_initialized;
     bool is_configured;
     bool is_driver_installed;
-    SemaphoreHandle_t mutex;
     nhal_timeout_ms timeout_ms;
+    // Bus arbitration: replaces a plain mutex so the most urgent waiter wins
+    portMUX_TYPE arb_lock;
+    bool bus_owned;
+    uint8_t arb_waiting;
+    TaskHandle_t arb_owner;
+    UBaseType_t arb_owner_base;     // Owner's own FreeRTOS priority
+    UBaseType_t arb_owner_prio;     // Owner's priority with waiters' lent to it
+    SemaphoreHandle_t arb_boost_lock;   // Orders priority changes against handoffs
+    StaticSemaphore_t arb_boost_lock_buffer;
+    struct nhal_i2c_arb_waiter arb_waiters[NHAL_ESP32_I2C_ARB_MAX_WAITERS];
+    struct nhal_i2c_arb_stats arb_stats[NHAL_ESP32_I2C_PRIORITY_CLASSES];
+#if NHAL_ESP32_I2C_BACKEND == NHAL_ESP32_I2C_BACKEND_MASTER_BUS
+    i2c_master_bus_handle_t bus_handle;
+    uint32_t clock_speed_hz;
+    struct nhal_i2c_dev_cache_entry dev_cache[NHAL_ESP32_I2C_DEV_CACHE_SIZE];
+    uint8_t dev_cache_next;     // Next slot to evict when the cache is full
+#endif
+    struct nhal_i2c_stats stats;
+};
+
+// Counted from driver events by whichever receiver, framer or RS-485 link
+// consumes the event queue; nothing is counted without one
+struct nhal_uart_stats {
+    uint32_t fifo_overflows;    // RX FIFO overflowed before the interrupt emptied it
+    uint32_t buffer_full;       // RX ring buffer full, bytes dropped
+    uint32_t frame_errors;
+    uint32_t parity_errors;
+    uint32_t breaks;
 };
 
 struct nhal_uart_context {
@@ -102,15 +218,88 @@ struct nhal_uart_context {
     bool is_driver_installed;
     SemaphoreHandle_t mutex;
     nhal_timeout_ms timeout_ms;
+    QueueHandle_t event_queue;  // Driver event queue, NULL when impl_config queue_size is 0
+    bool tx_buffered;           // impl_config tx_buffer_size > 0: writes go through the TX ring buffer
+    uart_mode_t uart_mode;      // impl_config uart_mode
+    bool events_claimed;        // A receiver task reads event_queue
+    portMUX_TYPE lock;          // Guards stats and events_claimed
+    struct nhal_uart_stats stats;
+};
+
+struct nhal_spi_size_class_stats {
+    uint32_t transactions;
+    uint64_t bytes;
+    uint64_t time_us;
+};
+
+// Index into nhal_spi_stats.line_modes: 1, 2 and 4 data lines
+#define NHAL_ESP32_SPI_LINE_MODES 3
+
+struct nhal_spi_line_mode_stats {
+    uint32_t transactions;
+    uint64_t bytes;
+    uint64_t bus_time_us;
+};
+
+struct nhal_spi_stats {
+    uint32_t transactions;      // Completed bus transactions (any result)
+    uint32_t errors;            // Transactions that did not return NHAL_OK
+    uint64_t bytes;             // Bytes clocked (transaction lengths)
+    uint64_t total_time_us;     // Time spent in the driver, bus time included
+    uint32_t max_time_us;       // Slowest single transaction
+    uint64_t bus_time_us;       // Time the bus was active (pre to post callback)
+    uint32_t polled;            // Transactions run on the polling path
+    uint64_t polled_time_us;    // Driver time of the polled transactions
+    uint32_t bounced;           // DMA transactions copied through the context bounce buffer
+    uint64_t bounced_bytes;
+    uint32_t driver_bounced;    // DMA transactions left for the driver to copy (allocates per call)
+    struct nhal_spi_size_class_stats size_classes[NHAL_ESP32_SPI_STATS_SIZE_CLASSES];
+    struct nhal_spi_line_mode_stats line_modes[NHAL_ESP32_SPI_LINE_MODES];
+};
+
+struct nhal_spi_bus_stats {
+    uint32_t device_switches;   // Transactions addressed to a different device than the previous one
+};
+
+/**
+ * An SPI host shared by several device contexts (see nhal_esp32_spi_bus.h).
+ * The bus is initialized once; every attached device keeps its own
+ * precomputed clock and mode settings in the driver.
+ */
+struct nhal_spi_bus {
+    spi_host_device_t spi_bus_id;
+    bool is_initialized;
+    bool use_dma;
+    uint8_t data_lines;
+    bool iomux_pins;            // Data and clock pins bypass the GPIO matrix
+    uint32_t num_devices;
+    portMUX_TYPE lock;          // Guards num_devices and stats
+    struct nhal_spi_context *last_device;
+    struct nhal_spi_bus_stats stats;
 };
 
 struct nhal_spi_context {
     spi_host_device_t spi_bus_id;
+    struct nhal_spi_bus *bus;   // Shared bus, or NULL if the context owns its host
+    uint32_t actual_frequency_hz; // Clock the driver really runs the device at
+    uint32_t max_frequency_hz;  // Fastest clock for the pin routing and duplex mode
+    bool iomux_pins;            // Data and clock pins bypass the GPIO matrix
     bool is_initialized;
     bool is_configured;
+    bool use_dma;
+    uint8_t queue_size;
+    uint16_t polling_threshold;
+    uint8_t data_lines;         // Widest data phase the bus is wired for
+    bool half_duplex;           // Required by dual and quad transactions
     spi_device_handle_t device_handle;
     SemaphoreHandle_t mutex;
+    TaskHandle_t bus_owner;     // Task holding the bus through nhal_esp32_spi_acquire()
+    uint32_t bus_owner_depth;
     nhal_timeout_ms timeout_ms;
+    uint8_t *bounce_buffer;
+    size_t bounce_buffer_size;
+    portMUX_TYPE stats_lock;
+    struct nhal_spi_stats stats;
 };
 
 #endif // NHAL_IMPL_ESP32_DEFS_H
@@ -0,0 +1,23 @@
+/**
+ * @file nhal_esp32_i2c.h
+ * @brief ESP32-specific extensions to the NHAL I2C master interface.
+ */
+#ifndef NHAL_ESP32_I2C_H
+#define NHAL_ESP32_I2C_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_i2c_types.h"
+
+/**
+ * @brief Copies the per-context transaction statistics.
+ *
+ * Every NHAL I2C call that reaches the bus is accounted, so running the same
+ * workload against both backends (NHAL_ESP32_I2C_BACKEND) gives the
+ * per-transaction driver overhead as the difference in
+ * total_time_us / transactions.
+ */
+nhal_result_t nhal_esp32_i2c_get_stats(struct nhal_i2c_context *ctx, struct nhal_i2c_stats *stats);
+
+nhal_result_t nhal_esp32_i2c_reset_stats(struct nhal_i2c_context *ctx);
+
+#endif // NHAL_ESP32_I2C_H
@@ -0,0 +1,114 @@
+/**
+ * @file nhal_esp32_i2c_arbiter.h
+ * @brief Priority- and deadline-aware I2C bus arbitration.
+ *
+ * Every I2C context arbitrates bus ownership between tasks. When the bus is
+ * released it is handed to the most urgent waiter, ranked by:
+ *   1. requests that have waited longer than NHAL_ESP32_I2C_ARB_AGING_US,
+ *      oldest first (this bounds the wait of any request),
+ *   2. priority class,
+ *   3. earliest deadline,
+ *   4. arrival order.
+ *
+ * While a task waits, the owner runs at no less than the waiter's FreeRTOS
+ * priority until it releases the bus (and the next owner inherits it if the
+ * waiter is still queued). A waiter is therefore held up only by the
+ * transfers ranked ahead of it, each bounded by the context timeout, and not
+ * by unrelated tasks preempting a low-priority owner. A waiter that times out
+ * keeps its priority lent until that owner releases the bus.
+ *
+ * The plain NHAL I2C calls run at NHAL_I2C_PRIORITY_NORMAL without a
+ * deadline; the *_ex variants below take explicit request attributes.
+ */
+#ifndef NHAL_ESP32_I2C_ARBITER_H
+#define NHAL_ESP32_I2C_ARBITER_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_i2c_types.h"
+
+// Waiters older than this are served before any newer request.
+#ifndef NHAL_ESP32_I2C_ARB_AGING_US
+#define NHAL_ESP32_I2C_ARB_AGING_US 20000
+#endif
+
+// Default chunk size of nhal_esp32_i2c_read_reg_chunked().
+#ifndef NHAL_ESP32_I2C_ARB_CHUNK_SIZE
+#define NHAL_ESP32_I2C_ARB_CHUNK_SIZE 32
+#endif
+
+typedef enum {
+    NHAL_I2C_PRIORITY_LOW       = 0,
+    NHAL_I2C_PRIORITY_NORMAL    = 1,
+    NHAL_I2C_PRIORITY_HIGH      = 2,
+    NHAL_I2C_PRIORITY_CRITICAL  = 3,
+} nhal_i2c_priority_t;
+
+struct nhal_i2c_request_attr {
+    nhal_i2c_priority_t priority;
+    /**
+     * Absolute deadline in nhal_get_timestamp_microseconds() time, or 0 for
+     * none. A request that cannot get the bus before its deadline returns
+     * NHAL_ERR_TIMEOUT without touching the bus. The wait is rounded up to
+     * whole FreeRTOS ticks, so a release up to one tick late still counts.
+     */
+    uint64_t deadline_us;
+};
+
+nhal_result_t nhal_esp32_i2c_write_ex(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *data, size_t len,
+    const struct nhal_i2c_request_attr *attr
+);
+
+nhal_result_t nhal_esp32_i2c_read_ex(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    uint8_t *data, size_t len,
+    const struct nhal_i2c_request_attr *attr
+);
+
+nhal_result_t nhal_esp32_i2c_write_read_reg_ex(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *reg_address, size_t reg_len,
+    uint8_t *data, size_t data_len,
+    const struct nhal_i2c_request_attr *attr
+);
+
+nhal_result_t nhal_esp32_i2c_perform_transfer_ex(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    nhal_i2c_transfer_op_t *ops, size_t num_ops,
+    const struct nhal_i2c_request_attr *attr
+);
+
+/**
+ * @brief Reads a long register/memory range as a series of shorter
+ * write-read transactions, releasing the bus between them so more urgent
+ * requests can run in between.
+ *
+ * The register address (big-endian, reg_len bytes) is advanced by the chunk
+ * length for each transaction, which matches auto-incrementing register
+ * files and sequential-read memories.
+ *
+ * @param chunk_size Bytes per transaction, 0 for NHAL_ESP32_I2C_ARB_CHUNK_SIZE.
+ */
+nhal_result_t nhal_esp32_i2c_read_reg_chunked(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *reg_address, size_t reg_len,
+    uint8_t *data, size_t data_len,
+    size_t chunk_size,
+    const struct nhal_i2c_request_attr *attr
+);
+
+/**
+ * @brief Copies the wait-time statistics of every priority class.
+ * @param stats Array of NHAL_ESP32_I2C_PRIORITY_CLASSES entries.
+ */
+nhal_result_t nhal_esp32_i2c_get_arb_stats(struct nhal_i2c_context *ctx, struct nhal_i2c_arb_stats *stats);
+
+nhal_result_t nhal_esp32_i2c_reset_arb_stats(struct nhal_i2c_context *ctx);
+
+#endif // NHAL_ESP32_I2C_ARBITER_H
@@ -0,0 +1,158 @@
+/**
+ * @file nhal_esp32_i2c_async.h
+ * @brief Non-blocking, queued I2C transactions with completion callbacks.
+ *
+ * An async engine owns a bounded job queue and a worker task that drains it
+ * through the regular blocking NHAL I2C calls, so synchronous and queued
+ * callers share the bus through the same context arbitration. All storage
+ * (queue, task stack and control block) lives inside struct nhal_i2c_async
+ * and is sized at build time.
+ *
+ * Buffers referenced by a job must stay valid until its completion is
+ * reported. A job that finds the bus busy is retried until the context
+ * timeout_ms has passed, then completes with NHAL_ERR_BUSY.
+ */
+#ifndef NHAL_ESP32_I2C_ASYNC_H
+#define NHAL_ESP32_I2C_ASYNC_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_i2c_types.h"
+#include "nhal_esp32_worker.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#ifndef NHAL_ESP32_I2C_ASYNC_QUEUE_DEPTH
+#define NHAL_ESP32_I2C_ASYNC_QUEUE_DEPTH 8
+#endif
+
+#ifndef NHAL_ESP32_I2C_ASYNC_TASK_STACK_SIZE
+#define NHAL_ESP32_I2C_ASYNC_TASK_STACK_SIZE 3072
+#endif
+
+#ifndef NHAL_ESP32_I2C_ASYNC_TASK_PRIORITY
+#define NHAL_ESP32_I2C_ASYNC_TASK_PRIORITY 5
+#endif
+
+typedef enum {
+    NHAL_I2C_ASYNC_OP_WRITE,
+    NHAL_I2C_ASYNC_OP_READ,
+    NHAL_I2C_ASYNC_OP_WRITE_READ_REG,
+    NHAL_I2C_ASYNC_OP_TRANSFER,
+    NHAL_I2C_ASYNC_OP_STOP,         // Internal: terminates the worker
+} nhal_i2c_async_op_t;
+
+struct nhal_i2c_async_completion {
+    uint32_t job_id;
+    nhal_result_t result;
+    uint64_t timestamp_us;          // nhal_get_timestamp_microseconds() at completion
+    void *user_data;
+};
+
+typedef void (*nhal_i2c_async_callback_t)(
+    struct nhal_i2c_context *ctx,
+    const struct nhal_i2c_async_completion *completion
+);
+
+/**
+ * @brief How a job reports completion. Any combination may be used:
+ * the callback runs first (in the worker task), then `completion` is filled
+ * and `notify_task` receives a task notification.
+ */
+struct nhal_i2c_async_notify {
+    nhal_i2c_async_callback_t callback;
+    void *user_data;
+    TaskHandle_t notify_task;
+    struct nhal_i2c_async_completion *completion;
+};
+
+struct nhal_i2c_async_job {
+    nhal_i2c_async_op_t op;
+    uint32_t job_id;
+    nhal_i2c_address_t dev_address;
+    union {
+        struct { const uint8_t *data; size_t len; } write;
+        struct { uint8_t *data; size_t len; } read;
+        struct { const uint8_t *reg; size_t reg_len; uint8_t *data; size_t data_len; } write_read;
+        struct { nhal_i2c_transfer_op_t *ops; size_t num_ops; } transfer;
+    };
+    struct nhal_i2c_async_notify notify;
+};
+
+struct nhal_i2c_async_stats {
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t failed;                // Completed with a result other than NHAL_OK
+    uint32_t rejected;              // Submissions refused because the queue was full
+    uint32_t max_queued;            // High-water mark of pending jobs
+};
+
+struct nhal_i2c_async {
+    struct nhal_i2c_context *ctx;
+    bool is_running;
+    uint32_t next_job_id;
+    QueueHandle_t queue;
+    StaticQueue_t queue_struct;
+    uint8_t queue_storage[NHAL_ESP32_I2C_ASYNC_QUEUE_DEPTH * sizeof(struct nhal_i2c_async_job)];
+    TaskHandle_t task;
+    StaticTask_t task_struct;
+    StackType_t task_stack[NHAL_ESP32_I2C_ASYNC_TASK_STACK_SIZE];
+    struct nhal_worker_gate gate;   // Serializes submissions against stop
+    portMUX_TYPE lock;              // Guards next_job_id and stats
+    struct nhal_i2c_async_stats stats;
+};
+
+/**
+ * @brief Starts the worker task for a configured I2C context.
+ */
+nhal_result_t nhal_esp32_i2c_async_start(struct nhal_i2c_async *async, struct nhal_i2c_context *ctx);
+
+/**
+ * @brief Lets the worker finish every queued job, then stops it.
+ */
+nhal_result_t nhal_esp32_i2c_async_stop(struct nhal_i2c_async *async);
+
+/**
+ * The submit functions never block: they return NHAL_ERR_BUSY when the queue
+ * is full. On success, *job_id (optional) identifies the job in its
+ * completion.
+ */
+nhal_result_t nhal_esp32_i2c_async_submit_write(
+    struct nhal_i2c_async *async,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *data, size_t len,
+    const struct nhal_i2c_async_notify *notify,
+    uint32_t *job_id
+);
+
+nhal_result_t nhal_esp32_i2c_async_submit_read(
+    struct nhal_i2c_async *async,
+    nhal_i2c_address_t dev_address,
+    uint8_t *data, size_t len,
+    const struct nhal_i2c_async_notify *notify,
+    uint32_t *job_id
+);
+
+nhal_result_t nhal_esp32_i2c_async_submit_write_read_reg(
+    struct nhal_i2c_async *async,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *reg_address, size_t reg_len,
+    uint8_t *data, size_t data_len,
+    const struct nhal_i2c_async_notify *notify,
+    uint32_t *job_id
+);
+
+nhal_result_t nhal_esp32_i2c_async_submit_transfer(
+    struct nhal_i2c_async *async,
+    nhal_i2c_address_t dev_address,
+    nhal_i2c_transfer_op_t *ops, size_t num_ops,
+    const struct nhal_i2c_async_notify *notify,
+    uint32_t *job_id
+);
+
+nhal_result_t nhal_esp32_i2c_async_get_stats(struct nhal_i2c_async *async, struct nhal_i2c_async_stats *stats);
+
+nhal_result_t nhal_esp32_i2c_async_reset_stats(struct nhal_i2c_async *async);
+
+#endif // NHAL_ESP32_I2C_ASYNC_H
@@ -0,0 +1,72 @@
+/**
+ * @file nhal_esp32_i2c_backend.h
+ * @brief Private interface between the NHAL I2C entry points and the
+ * ESP-IDF driver backend selected by NHAL_ESP32_I2C_BACKEND. It should not
+ * be included directly by higher-level application code.
+ *
+ * Backend functions assume the caller already owns the bus (see
+ * nhal_i2c_bus_acquire) and has validated the context state.
+ */
+#ifndef NHAL_ESP32_I2C_BACKEND_H
+#define NHAL_ESP32_I2C_BACKEND_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_i2c_types.h"
+
+nhal_result_t nhal_i2c_backend_install(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config);
+nhal_result_t nhal_i2c_backend_uninstall(struct nhal_i2c_context *ctx);
+
+nhal_result_t nhal_i2c_backend_write(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const uint8_t *data, size_t len);
+nhal_result_t nhal_i2c_backend_read(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, uint8_t *data, size_t len);
+nhal_result_t nhal_i2c_backend_write_read(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *reg_address, size_t reg_len,
+    uint8_t *data, size_t data_len
+);
+nhal_result_t nhal_i2c_backend_transfer(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    nhal_i2c_transfer_op_t *ops,
+    size_t num_ops
+);
+
+struct nhal_i2c_prepared_transfer;
+
+nhal_result_t nhal_i2c_backend_prepare(struct nhal_i2c_prepared_transfer *prepared);
+nhal_result_t nhal_i2c_backend_execute_prepared(struct nhal_i2c_prepared_transfer *prepared);
+void nhal_i2c_backend_release_prepared(struct nhal_i2c_prepared_transfer *prepared);
+
+struct nhal_i2c_request_attr;
+
+// Attributes used by the plain NHAL I2C entry points
+extern const struct nhal_i2c_request_attr nhal_i2c_default_request_attr;
+
+void nhal_i2c_arbiter_init(struct nhal_i2c_context *ctx);
+void nhal_i2c_arbiter_deinit(struct nhal_i2c_context *ctx);
+
+/**
+ * @brief Waits until the bus is granted to the caller.
+ * @return NHAL_ERR_BUSY when ctx->timeout_ms elapses first,
+ *         NHAL_ERR_TIMEOUT when the request deadline passes first.
+ */
+nhal_result_t nhal_i2c_bus_acquire(struct nhal_i2c_context *ctx, const struct nhal_i2c_request_attr *attr);
+
+/**
+ * @brief Hands the bus to the most urgent waiter, or frees it.
+ */
+void nhal_i2c_bus_release(struct nhal_i2c_context *ctx);
+
+/**
+ * @brief Accounts one backend call in ctx->stats.
+ * @param start_us Timestamp taken right before the backend call.
+ */
+void nhal_i2c_stats_record(struct nhal_i2c_context *ctx, uint64_t start_us, nhal_result_t result);
+
+/**
+ * @brief Increments one ctx->stats counter under the lock that guards the
+ * rest of the stats.
+ */
+void nhal_i2c_stats_count(struct nhal_i2c_context *ctx, uint32_t *counter);
+
+#endif // NHAL_ESP32_I2C_BACKEND_H
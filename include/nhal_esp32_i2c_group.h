@@ -0,0 +1,87 @@
+/**
+ * @file nhal_esp32_i2c_group.h
+ * @brief Fan-out of batched I2C reads across several I2C controllers.
+ *
+ * A bus group owns one async engine (see nhal_esp32_i2c_async.h) per member
+ * context. A batch of register reads is handed out round-robin over the
+ * member buses, so the controllers run their share of the batch at the same
+ * time, and the call returns when every read has completed.
+ */
+#ifndef NHAL_ESP32_I2C_GROUP_H
+#define NHAL_ESP32_I2C_GROUP_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_i2c_async.h"
+#include "nhal_i2c_types.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#ifndef NHAL_ESP32_I2C_GROUP_MAX_BUSES
+#define NHAL_ESP32_I2C_GROUP_MAX_BUSES 2
+#endif
+
+struct nhal_i2c_group_read {
+    size_t bus_index;                   // Member bus the device sits on
+    nhal_i2c_address_t dev_address;
+    const uint8_t *reg_address;
+    size_t reg_len;
+    uint8_t *data;
+    size_t data_len;
+    nhal_result_t result;               // Filled in by the group
+    SemaphoreHandle_t done;             // Internal
+};
+
+struct nhal_i2c_group_stats {
+    uint32_t batches;
+    uint32_t reads;
+    uint32_t errors;
+    uint64_t batch_time_us;             // Wall time of all batches
+    uint64_t bus_time_us;               // Summed backend time of every member bus during batches
+};
+
+struct nhal_i2c_group {
+    size_t num_buses;
+    bool is_initialized;
+    struct nhal_i2c_context *buses[NHAL_ESP32_I2C_GROUP_MAX_BUSES];
+    struct nhal_i2c_async engines[NHAL_ESP32_I2C_GROUP_MAX_BUSES];
+    portMUX_TYPE lock;                  // Guards stats
+    struct nhal_i2c_group_stats stats;
+};
+
+/**
+ * @brief Starts one worker per member context. Every context must be
+ * configured and drive a different controller.
+ */
+nhal_result_t nhal_esp32_i2c_group_init(
+    struct nhal_i2c_group *group,
+    struct nhal_i2c_context *const *buses,
+    size_t num_buses
+);
+
+nhal_result_t nhal_esp32_i2c_group_deinit(struct nhal_i2c_group *group);
+
+/**
+ * @brief Runs a batch of register reads concurrently across the member
+ * buses and waits for all of them.
+ *
+ * Each read reports its own result; the return value is NHAL_OK when every
+ * read succeeded, else the first failing result in batch order.
+ */
+nhal_result_t nhal_esp32_i2c_group_read_batch(
+    struct nhal_i2c_group *group,
+    struct nhal_i2c_group_read *reads,
+    size_t num_reads
+);
+
+/**
+ * The achieved parallelism of the batches is bus_time_us / batch_time_us:
+ * 1.0 means the buses were used one after another, 2.0 that two buses were
+ * busy for the whole batch. Bus time is taken from the member context
+ * statistics, so concurrent non-batch traffic is counted as well.
+ */
+nhal_result_t nhal_esp32_i2c_group_get_stats(struct nhal_i2c_group *group, struct nhal_i2c_group_stats *stats);
+
+nhal_result_t nhal_esp32_i2c_group_reset_stats(struct nhal_i2c_group *group);
+
+#endif // NHAL_ESP32_I2C_GROUP_H
@@ -0,0 +1,119 @@
+/**
+ * @file nhal_esp32_i2c_mem.h
+ * @brief Page-aware I2C EEPROM/FRAM access with ACK polling.
+ *
+ * Writes are split at page boundaries and, for memories with more address
+ * bits than the word address carries (24C04..24C16 style), at block
+ * boundaries encoded in the device address. Instead of sleeping a fixed
+ * write-cycle time after every page, the next page is retried until the
+ * device ACKs its address again, so it is sent as soon as the previous write
+ * cycle ends. The final write cycle of a call is left running; it is waited
+ * for by the next access or by nhal_esp32_i2c_mem_sync().
+ */
+#ifndef NHAL_ESP32_I2C_MEM_H
+#define NHAL_ESP32_I2C_MEM_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_i2c_types.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// Largest page (and FRAM write chunk) sent in one transaction
+#ifndef NHAL_ESP32_I2C_MEM_MAX_PAGE_SIZE
+#define NHAL_ESP32_I2C_MEM_MAX_PAGE_SIZE 256
+#endif
+
+#ifndef NHAL_ESP32_I2C_MEM_POLL_MIN_US
+#define NHAL_ESP32_I2C_MEM_POLL_MIN_US 50
+#endif
+
+#ifndef NHAL_ESP32_I2C_MEM_POLL_MAX_US
+#define NHAL_ESP32_I2C_MEM_POLL_MAX_US 400
+#endif
+
+typedef enum {
+    NHAL_I2C_MEM_CYCLE_NONE,        // FRAM: writes complete at the STOP condition
+    NHAL_I2C_MEM_CYCLE_ACK_POLL,    // EEPROM: poll the device address until it ACKs
+    NHAL_I2C_MEM_CYCLE_FIXED_DELAY, // EEPROM: sleep write_cycle_us after each page
+} nhal_i2c_mem_cycle_t;
+
+struct nhal_i2c_mem_config {
+    nhal_i2c_address_t dev_address;     // Base address; block bits are ORed in
+    uint32_t size_bytes;
+    uint16_t page_size;                 // Power of two; 0 for no page limit (FRAM)
+    uint8_t addr_width;                 // Word address bytes: 1 or 2
+    uint8_t block_bits;                 // High address bits carried in the device address (0..3)
+    nhal_i2c_mem_cycle_t cycle_mode;
+    uint32_t write_cycle_us;            // Fixed delay, or ACK-poll give-up time
+    uint32_t poll_min_us;               // First poll interval, 0 for NHAL_ESP32_I2C_MEM_POLL_MIN_US
+    uint32_t poll_max_us;               // Poll interval bound, 0 for NHAL_ESP32_I2C_MEM_POLL_MAX_US
+};
+
+struct nhal_i2c_mem_stats {
+    uint32_t bytes_written;
+    uint32_t bytes_read;
+    uint32_t pages_written;
+    uint32_t ack_polls;                 // Attempts NACKed by a busy device
+    uint32_t write_cycles;              // Write cycles waited for
+    uint32_t max_cycle_us;
+    uint64_t total_cycle_us;
+    uint64_t write_time_us;             // Time in write and sync calls
+};
+
+struct nhal_i2c_mem {
+    struct nhal_i2c_context *ctx;
+    struct nhal_i2c_mem_config config;
+    bool is_initialized;
+    bool cycle_pending;
+    uint64_t cycle_start_us;
+    nhal_i2c_address_t last_device;
+    SemaphoreHandle_t mutex;
+    StaticSemaphore_t mutex_buffer;
+    uint8_t frame[2 + NHAL_ESP32_I2C_MEM_MAX_PAGE_SIZE];
+    portMUX_TYPE stats_lock;            // Guards stats, so reading them never waits for a write
+    struct nhal_i2c_mem_stats stats;
+};
+
+nhal_result_t nhal_esp32_i2c_mem_init(
+    struct nhal_i2c_mem *mem,
+    struct nhal_i2c_context *ctx,
+    const struct nhal_i2c_mem_config *config
+);
+
+nhal_result_t nhal_esp32_i2c_mem_deinit(struct nhal_i2c_mem *mem);
+
+/**
+ * @brief Writes len bytes at mem_address, page by page. Returns once the
+ * last page is sent; its write cycle may still be running.
+ */
+nhal_result_t nhal_esp32_i2c_mem_write(
+    struct nhal_i2c_mem *mem,
+    uint32_t mem_address,
+    const uint8_t *data, size_t len
+);
+
+/**
+ * @brief Reads len bytes at mem_address, after any pending write cycle.
+ */
+nhal_result_t nhal_esp32_i2c_mem_read(
+    struct nhal_i2c_mem *mem,
+    uint32_t mem_address,
+    uint8_t *data, size_t len
+);
+
+/**
+ * @brief Waits for a pending write cycle to end.
+ */
+nhal_result_t nhal_esp32_i2c_mem_sync(struct nhal_i2c_mem *mem);
+
+/**
+ * Write throughput in bytes/s is bytes_written * 1000000 / write_time_us;
+ * call nhal_esp32_i2c_mem_sync() after the last write so the final write
+ * cycle is included.
+ */
+nhal_result_t nhal_esp32_i2c_mem_get_stats(struct nhal_i2c_mem *mem, struct nhal_i2c_mem_stats *stats);
+
+nhal_result_t nhal_esp32_i2c_mem_reset_stats(struct nhal_i2c_mem *mem);
+
+#endif // NHAL_ESP32_I2C_MEM_H
@@ -0,0 +1,93 @@
+/**
+ * @file nhal_esp32_i2c_prepared.h
+ * @brief Prepared ("compile once, execute many") I2C transfer descriptors.
+ *
+ * A prepared transfer keeps a copy of a nhal_i2c_transfer_op_t sequence and,
+ * with the legacy backend, the command link built from it inside a
+ * caller-provided buffer. Executing it never touches the heap; swapping data
+ * buffers only rebuilds the link in place on the next execution.
+ */
+#ifndef NHAL_ESP32_I2C_PREPARED_H
+#define NHAL_ESP32_I2C_PREPARED_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_i2c_types.h"
+
+#ifndef NHAL_ESP32_I2C_PREPARED_MAX_OPS
+#define NHAL_ESP32_I2C_PREPARED_MAX_OPS 8
+#endif
+
+/**
+ * @brief Link buffer size, in bytes, needed for a sequence of num_ops ops.
+ * The master bus backend builds no command link and needs no storage.
+ */
+#if NHAL_ESP32_I2C_BACKEND == NHAL_ESP32_I2C_BACKEND_LEGACY
+#define NHAL_ESP32_I2C_PREPARED_BUFFER_SIZE(num_ops) I2C_LINK_RECOMMENDED_SIZE(num_ops)
+#else
+#define NHAL_ESP32_I2C_PREPARED_BUFFER_SIZE(num_ops) 1
+#endif
+
+struct nhal_i2c_prepared_stats {
+    uint32_t executions;    // Times the descriptor was run on the bus
+    uint32_t rebuilds;      // Command link rebuilds caused by buffer swaps
+};
+
+struct nhal_i2c_prepared_transfer {
+    struct nhal_i2c_context *ctx;
+    nhal_i2c_address_t dev_address;
+    nhal_i2c_transfer_op_t ops[NHAL_ESP32_I2C_PREPARED_MAX_OPS];
+    size_t num_ops;
+    uint8_t *link_buffer;
+    size_t link_buffer_size;
+    bool is_prepared;
+    bool needs_rebuild;
+#if NHAL_ESP32_I2C_BACKEND == NHAL_ESP32_I2C_BACKEND_LEGACY
+    uint8_t esp_addr;
+    i2c_cmd_handle_t cmd;
+#endif
+    struct nhal_i2c_prepared_stats stats;
+};
+
+/**
+ * @brief Compiles an op sequence into a reusable descriptor.
+ *
+ * @param link_buffer Storage for the command link, at least
+ *        NHAL_ESP32_I2C_PREPARED_BUFFER_SIZE(num_ops) bytes. It must outlive
+ *        the descriptor.
+ * @return NHAL_ERR_OUT_OF_MEMORY if link_buffer is too small for the sequence.
+ */
+nhal_result_t nhal_esp32_i2c_prepare_transfer(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const nhal_i2c_transfer_op_t *ops,
+    size_t num_ops,
+    uint8_t *link_buffer,
+    size_t link_buffer_size,
+    struct nhal_i2c_prepared_transfer *prepared
+);
+
+/**
+ * @brief Points a write op of the descriptor at new data.
+ */
+nhal_result_t nhal_esp32_i2c_prepared_set_write_buffer(
+    struct nhal_i2c_prepared_transfer *prepared,
+    size_t op_index,
+    const uint8_t *bytes,
+    size_t length
+);
+
+/**
+ * @brief Points a read op of the descriptor at a new destination.
+ */
+nhal_result_t nhal_esp32_i2c_prepared_set_read_buffer(
+    struct nhal_i2c_prepared_transfer *prepared,
+    size_t op_index,
+    uint8_t *buffer,
+    size_t length
+);
+
+nhal_result_t nhal_esp32_i2c_execute_prepared(struct nhal_i2c_prepared_transfer *prepared);
+
+nhal_result_t nhal_esp32_i2c_release_prepared(struct nhal_i2c_prepared_transfer *prepared);
+
+#endif // NHAL_ESP32_I2C_PREPARED_H
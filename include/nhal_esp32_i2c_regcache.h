@@ -0,0 +1,128 @@
+/**
+ * @file nhal_esp32_i2c_regcache.h
+ * @brief Write-back register shadow cache for I2C devices with 8-bit
+ * register addresses and auto-incrementing register files.
+ *
+ * Registers of the cached window start out volatile: every access goes to
+ * the bus. Registers declared cacheable are shadowed in RAM; reads of valid
+ * entries are served from memory and writes only mark them dirty until
+ * nhal_esp32_i2c_regcache_flush() sends adjacent dirty registers as single
+ * burst writes.
+ */
+#ifndef NHAL_ESP32_I2C_REGCACHE_H
+#define NHAL_ESP32_I2C_REGCACHE_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_i2c_types.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// Largest register window a cache can cover
+#ifndef NHAL_ESP32_I2C_REGCACHE_MAX_REGS
+#define NHAL_ESP32_I2C_REGCACHE_MAX_REGS 64
+#endif
+
+// Largest number of data bytes sent in one burst write
+#ifndef NHAL_ESP32_I2C_REGCACHE_MAX_BURST
+#define NHAL_ESP32_I2C_REGCACHE_MAX_BURST 32
+#endif
+
+// Clean cached registers a flush burst may rewrite to join two dirty runs
+#ifndef NHAL_ESP32_I2C_REGCACHE_MAX_GAP
+#define NHAL_ESP32_I2C_REGCACHE_MAX_GAP 2
+#endif
+
+#define NHAL_ESP32_I2C_REGCACHE_BITMAP_SIZE ((NHAL_ESP32_I2C_REGCACHE_MAX_REGS + 7) / 8)
+
+struct nhal_i2c_regcache_stats {
+    uint32_t hits;              // Cacheable register reads served from memory
+    uint32_t misses;            // Cacheable register reads that went to the bus
+    uint32_t bus_reads;         // Read transactions issued
+    uint32_t bus_writes;        // Write transactions issued (volatile writes and flush bursts)
+    uint32_t flushed_regs;      // Registers written back by flushes
+};
+
+struct nhal_i2c_regcache {
+    struct nhal_i2c_context *ctx;
+    nhal_i2c_address_t dev_address;
+    uint8_t first_reg;
+    uint8_t num_regs;
+    bool is_initialized;
+    SemaphoreHandle_t mutex;
+    StaticSemaphore_t mutex_buffer;
+    uint8_t shadow[NHAL_ESP32_I2C_REGCACHE_MAX_REGS];
+    uint8_t cacheable[NHAL_ESP32_I2C_REGCACHE_BITMAP_SIZE];
+    uint8_t valid[NHAL_ESP32_I2C_REGCACHE_BITMAP_SIZE];
+    uint8_t dirty[NHAL_ESP32_I2C_REGCACHE_BITMAP_SIZE];
+    portMUX_TYPE stats_lock;
+    struct nhal_i2c_regcache_stats stats;
+};
+
+/**
+ * @brief Binds a cache to a device and a register window
+ * [first_reg, first_reg + num_regs). All registers start volatile.
+ */
+nhal_result_t nhal_esp32_i2c_regcache_init(
+    struct nhal_i2c_regcache *cache,
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    uint8_t first_reg,
+    uint8_t num_regs
+);
+
+nhal_result_t nhal_esp32_i2c_regcache_deinit(struct nhal_i2c_regcache *cache);
+
+/**
+ * @brief Declares registers [reg, reg + count) cacheable or volatile.
+ * Making a dirty register volatile keeps it dirty until the next flush.
+ */
+nhal_result_t nhal_esp32_i2c_regcache_set_cacheable(
+    struct nhal_i2c_regcache *cache,
+    uint8_t reg, size_t count,
+    bool cacheable
+);
+
+/**
+ * @brief Reads consecutive registers. Valid cached entries come from memory;
+ * the rest are fetched in as few burst reads as possible.
+ */
+nhal_result_t nhal_esp32_i2c_regcache_read(
+    struct nhal_i2c_regcache *cache,
+    uint8_t reg, uint8_t *values, size_t count
+);
+
+/**
+ * @brief Writes consecutive registers. Cacheable registers are only updated
+ * in memory and marked dirty; volatile ones are written to the bus at once.
+ */
+nhal_result_t nhal_esp32_i2c_regcache_write(
+    struct nhal_i2c_regcache *cache,
+    uint8_t reg, const uint8_t *values, size_t count
+);
+
+/**
+ * @brief Read-modify-write of the bits selected by mask.
+ */
+nhal_result_t nhal_esp32_i2c_regcache_update_bits(
+    struct nhal_i2c_regcache *cache,
+    uint8_t reg, uint8_t mask, uint8_t value
+);
+
+/**
+ * @brief Writes every dirty register back to the device, merging adjacent
+ * (or nearly adjacent) dirty registers into auto-increment burst writes.
+ */
+nhal_result_t nhal_esp32_i2c_regcache_flush(struct nhal_i2c_regcache *cache);
+
+/**
+ * @brief Forgets every clean cached value, e.g. after a device reset.
+ * Dirty registers are kept.
+ */
+nhal_result_t nhal_esp32_i2c_regcache_invalidate(struct nhal_i2c_regcache *cache);
+
+nhal_result_t nhal_esp32_i2c_regcache_get_stats(struct nhal_i2c_regcache *cache, struct nhal_i2c_regcache_stats *stats);
+
+nhal_result_t nhal_esp32_i2c_regcache_reset_stats(struct nhal_i2c_regcache *cache);
+
+#endif // NHAL_ESP32_I2C_REGCACHE_H
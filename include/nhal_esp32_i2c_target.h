@@ -0,0 +1,140 @@
+/**
+ * @file nhal_esp32_i2c_target.h
+ * @brief I2C target (slave) mode exposing a register window to a host.
+ *
+ * The host sees a classic register device: the first byte of a write sets
+ * the register pointer, following bytes are stored at consecutive registers,
+ * and a read returns registers from the pointer on.
+ *
+ * Host writes are applied to the caller's register array directly in the
+ * driver's receive callback (ISR context): each written register is marked
+ * in a dirty bitmap and the burst is reported through an ISR callback, so no
+ * task runs per byte or per write. Host reads are answered the same way: the
+ * request interrupt copies the next tx_chunk registers straight into the
+ * controller's TX FIFO while it stretches the clock, so read latency does
+ * not depend on task scheduling.
+ *
+ * Requires the I2C slave driver v2 (ESP-IDF 5.4+,
+ * CONFIG_I2C_ENABLE_SLAVE_DRIVER_VERSION_2) and the master bus backend; with
+ * the legacy backend every call returns NHAL_ERR_UNSUPPORTED.
+ */
+#ifndef NHAL_ESP32_I2C_TARGET_H
+#define NHAL_ESP32_I2C_TARGET_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_i2c_types.h"
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+
+#if NHAL_ESP32_I2C_BACKEND == NHAL_ESP32_I2C_BACKEND_MASTER_BUS && defined(CONFIG_I2C_ENABLE_SLAVE_DRIVER_VERSION_2)
+#define NHAL_ESP32_I2C_TARGET_SUPPORTED 1
+#include "driver/i2c_slave.h"
+#include "hal/i2c_ll.h"
+#include "soc/soc_caps.h"
+#else
+#define NHAL_ESP32_I2C_TARGET_SUPPORTED 0
+#endif
+
+// Registers an 8-bit register pointer can address
+#define NHAL_ESP32_I2C_TARGET_MAX_REGS 256
+
+// Default bytes queued per host read request
+#ifndef NHAL_ESP32_I2C_TARGET_TX_CHUNK
+#define NHAL_ESP32_I2C_TARGET_TX_CHUNK 4
+#endif
+
+#ifndef NHAL_ESP32_I2C_TARGET_BUF_DEPTH
+#define NHAL_ESP32_I2C_TARGET_BUF_DEPTH 64
+#endif
+
+struct nhal_i2c_target;
+
+/**
+ * Called from ISR context after a host write burst has stored registers in
+ * [first_reg, first_reg + count), the span from the first to the last
+ * register actually stored; read-only registers inside it are unchanged.
+ * The dirty bitmap is exact. Must be IRAM-safe and short.
+ * @return true if a higher-priority task was woken.
+ */
+typedef bool (*nhal_i2c_target_write_cb_t)(
+    struct nhal_i2c_target *target,
+    uint8_t first_reg, size_t count,
+    void *user_data
+);
+
+struct nhal_i2c_target_config {
+    int i2c_bus_id;
+    int sda_io_num;
+    int scl_io_num;
+    bool enable_internal_pullup;
+    nhal_i2c_address_t address;
+    uint8_t *regs;                      // Register window, owned by the caller
+    size_t num_regs;                    // 1..NHAL_ESP32_I2C_TARGET_MAX_REGS
+    const uint8_t *writable;            // Bitmap of host-writable registers, NULL for all
+    /**
+     * Bytes queued per read request, 0 for NHAL_ESP32_I2C_TARGET_TX_CHUNK;
+     * at most the controller's TX FIFO (SOC_I2C_FIFO_LEN). Bytes a read
+     * leaves queued are the next registers in sequence and are returned
+     * first by a following read, as queued; a host write of a new pointer
+     * discards them.
+     */
+    size_t tx_chunk;
+    nhal_i2c_target_write_cb_t on_write;
+    void *user_data;
+};
+
+struct nhal_i2c_target_stats {
+    uint32_t write_bursts;              // Host writes that stored at least one register
+    uint32_t bytes_written;             // Registers stored by the host
+    uint32_t bytes_rejected;            // Host bytes for read-only or out-of-window registers
+    uint32_t read_requests;             // Read requests served
+    uint32_t bytes_sent;                // Queued for the host
+    uint32_t bytes_discarded;           // Queued but never clocked out, dropped by a new pointer
+};
+
+struct nhal_i2c_target {
+    struct nhal_i2c_target_config config;
+    bool is_running;
+    portMUX_TYPE lock;                  // Guards regs, pointers, dirty and stats against the ISR
+    uint8_t read_ptr;                   // Next register to queue; set by host writes
+    uint8_t dirty[NHAL_ESP32_I2C_TARGET_MAX_REGS / 8];
+    struct nhal_i2c_target_stats stats;
+#if NHAL_ESP32_I2C_TARGET_SUPPORTED
+    i2c_slave_dev_handle_t handle;
+#endif
+};
+
+nhal_result_t nhal_esp32_i2c_target_start(struct nhal_i2c_target *target, const struct nhal_i2c_target_config *config);
+
+nhal_result_t nhal_esp32_i2c_target_stop(struct nhal_i2c_target *target);
+
+/**
+ * @brief Updates registers from the application side, atomically with
+ * respect to host reads. Does not mark them dirty.
+ */
+nhal_result_t nhal_esp32_i2c_target_update(
+    struct nhal_i2c_target *target,
+    uint8_t reg, const uint8_t *values, size_t count
+);
+
+/**
+ * @brief Copies registers, atomically with respect to host writes.
+ */
+nhal_result_t nhal_esp32_i2c_target_fetch(
+    struct nhal_i2c_target *target,
+    uint8_t reg, uint8_t *values, size_t count
+);
+
+/**
+ * @brief Copies the bitmap of registers written by the host since the last
+ * call into dirty (NHAL_ESP32_I2C_TARGET_MAX_REGS / 8 bytes) and clears it.
+ * @return true if any register was dirty.
+ */
+bool nhal_esp32_i2c_target_take_dirty(struct nhal_i2c_target *target, uint8_t *dirty);
+
+nhal_result_t nhal_esp32_i2c_target_get_stats(struct nhal_i2c_target *target, struct nhal_i2c_target_stats *stats);
+
+nhal_result_t nhal_esp32_i2c_target_reset_stats(struct nhal_i2c_target *target);
+
+#endif // NHAL_ESP32_I2C_TARGET_H
@@ -0,0 +1,167 @@
+/**
+ * @file nhal_esp32_sampler.h
+ * @brief Periodic I2C/SPI sampling engine feeding lock-free ring buffers.
+ *
+ * A sampler runs a static schedule table of streams from one high-priority
+ * task. Every stream samples one device at its own period; all periods are
+ * phase-aligned to the sampler start time, so a stream with period P and
+ * phase F is sampled at start + F + k * P. Each sample is stored with its
+ * timestamp in the stream's single-producer/single-consumer ring, which the
+ * application drains in batches without locks.
+ */
+#ifndef NHAL_ESP32_SAMPLER_H
+#define NHAL_ESP32_SAMPLER_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_i2c_types.h"
+#include "nhal_spi_types.h"
+#include "nhal_esp32_worker.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#ifndef NHAL_ESP32_SAMPLER_TASK_STACK_SIZE
+#define NHAL_ESP32_SAMPLER_TASK_STACK_SIZE 3072
+#endif
+
+#ifndef NHAL_ESP32_SAMPLER_TASK_PRIORITY
+#define NHAL_ESP32_SAMPLER_TASK_PRIORITY (configMAX_PRIORITIES - 2)
+#endif
+
+// Longest register address / command prefix of a stream
+#ifndef NHAL_ESP32_SAMPLER_MAX_CMD_LEN
+#define NHAL_ESP32_SAMPLER_MAX_CMD_LEN 4
+#endif
+
+// Longest SPI frame (command + sample) the sampler can clock
+#ifndef NHAL_ESP32_SAMPLER_MAX_SPI_LEN
+#define NHAL_ESP32_SAMPLER_MAX_SPI_LEN 64
+#endif
+
+struct nhal_sampler_record {
+    uint64_t timestamp_us;      // nhal_get_timestamp_microseconds() at sample start
+    nhal_result_t result;
+    uint16_t length;            // Valid bytes in data
+    uint8_t data[];
+};
+
+/**
+ * Bytes occupied by one record of a stream with sample_len bytes per sample.
+ */
+#define NHAL_ESP32_SAMPLER_RECORD_STRIDE(sample_len) \
+    ((sizeof(struct nhal_sampler_record) + (sample_len) + 7u) & ~(size_t)7u)
+
+/**
+ * Storage needed for a ring of num_records (a power of two) records.
+ */
+#define NHAL_ESP32_SAMPLER_RING_STORAGE_SIZE(sample_len, num_records) \
+    (NHAL_ESP32_SAMPLER_RECORD_STRIDE(sample_len) * (num_records))
+
+struct nhal_sampler_ring {
+    uint8_t *storage;
+    uint32_t capacity;          // Records; a power of two
+    uint32_t stride;            // Bytes per record
+    uint32_t head;              // Next record to write; owned by the sampler task
+    uint32_t tail;              // Next record to read; owned by the consumer
+    uint32_t dropped;           // Samples lost because the ring was full
+};
+
+typedef enum {
+    NHAL_SAMPLER_BUS_I2C,
+    NHAL_SAMPLER_BUS_SPI,
+} nhal_sampler_bus_t;
+
+struct nhal_sampler_stream_stats {
+    uint32_t samples;           // Samples taken (any result)
+    uint32_t errors;            // Samples whose bus transaction failed
+    uint32_t overruns;          // Sample slots skipped because the sampler was late
+    uint32_t max_jitter_us;     // Worst start delay after the scheduled time
+    uint64_t total_jitter_us;   // Sum of start delays, for the mean
+};
+
+struct nhal_sampler_stream {
+    // Schedule entry, filled in by the application
+    nhal_sampler_bus_t bus;
+    union {
+        struct nhal_i2c_context *i2c;
+        struct nhal_spi_context *spi;
+    };
+    nhal_i2c_address_t dev_address;                 // I2C only
+    uint8_t command[NHAL_ESP32_SAMPLER_MAX_CMD_LEN]; // I2C register address or SPI command
+    uint8_t command_len;
+    uint16_t sample_len;
+    uint32_t period_us;
+    uint32_t phase_us;
+    struct nhal_sampler_ring *ring;
+
+    // Runtime state, owned by the sampler
+    uint64_t next_due_us;
+    struct nhal_sampler_stream_stats stats;
+};
+
+struct nhal_sampler {
+    struct nhal_sampler_stream *streams;
+    size_t num_streams;
+    bool is_running;
+    uint64_t epoch_us;
+    esp_timer_handle_t timer;
+    TaskHandle_t task;
+    StaticTask_t task_struct;
+    StackType_t task_stack[NHAL_ESP32_SAMPLER_TASK_STACK_SIZE];
+    struct nhal_worker_gate gate;   // Only its exit semaphore is used
+    portMUX_TYPE lock;              // Guards the stream stats
+    uint8_t spi_tx[NHAL_ESP32_SAMPLER_MAX_SPI_LEN];
+    uint8_t spi_rx[NHAL_ESP32_SAMPLER_MAX_SPI_LEN];
+};
+
+/**
+ * @brief Prepares a ring over caller storage for samples of sample_len bytes.
+ * The storage must be 8-byte aligned; the capacity is the largest power of
+ * two number of records that fits in storage_size.
+ */
+nhal_result_t nhal_esp32_sampler_ring_init(
+    struct nhal_sampler_ring *ring,
+    uint8_t *storage, size_t storage_size,
+    uint16_t sample_len
+);
+
+/**
+ * @brief Returns the oldest unread records as one contiguous span, without
+ * copying. The span stays valid until nhal_esp32_sampler_ring_consume().
+ * @return Number of records in the span (0 when empty).
+ */
+size_t nhal_esp32_sampler_ring_peek(struct nhal_sampler_ring *ring, const uint8_t **span);
+
+/**
+ * @brief Releases the first count records returned by the last peek.
+ */
+void nhal_esp32_sampler_ring_consume(struct nhal_sampler_ring *ring, size_t count);
+
+static inline const struct nhal_sampler_record *nhal_esp32_sampler_ring_record(
+    const struct nhal_sampler_ring *ring, const uint8_t *span, size_t index)
+{
+    return (const struct nhal_sampler_record *)(span + (size_t)index * ring->stride);
+}
+
+/**
+ * @brief Starts sampling the schedule table. The table must stay valid and
+ * unmodified while the sampler runs.
+ */
+nhal_result_t nhal_esp32_sampler_start(
+    struct nhal_sampler *sampler,
+    struct nhal_sampler_stream *streams,
+    size_t num_streams
+);
+
+nhal_result_t nhal_esp32_sampler_stop(struct nhal_sampler *sampler);
+
+nhal_result_t nhal_esp32_sampler_get_stream_stats(
+    struct nhal_sampler *sampler,
+    size_t stream_index,
+    struct nhal_sampler_stream_stats *stats
+);
+
+nhal_result_t nhal_esp32_sampler_reset_stream_stats(struct nhal_sampler *sampler, size_t stream_index);
+
+#endif // NHAL_ESP32_SAMPLER_H
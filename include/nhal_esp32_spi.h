@@ -0,0 +1,62 @@
+/**
+ * @file nhal_esp32_spi.h
+ * @brief ESP32-specific extensions to the NHAL SPI master interface.
+ */
+#ifndef NHAL_ESP32_SPI_H
+#define NHAL_ESP32_SPI_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_spi_types.h"
+
+// Highest SCLK on the native IOMUX pins and through the GPIO matrix
+#ifndef NHAL_ESP32_SPI_MAX_FREQ_IOMUX_HZ
+#define NHAL_ESP32_SPI_MAX_FREQ_IOMUX_HZ 80000000
+#endif
+
+#ifndef NHAL_ESP32_SPI_MAX_FREQ_GPIO_HZ
+#define NHAL_ESP32_SPI_MAX_FREQ_GPIO_HZ 40000000
+#endif
+
+/**
+ * @brief Copies the per-context transaction statistics.
+ *
+ * Throughput per transfer size is size_classes[i].bytes * 1000000 /
+ * size_classes[i].time_us bytes/s; class 0 holds transfers up to 64 bytes
+ * and each following class doubles the limit, so a 64 B .. 32 KB sweep fills
+ * every class.
+ *
+ * bus_time_us only grows while a transaction is on the bus, so the bus
+ * utilization over an interval is the bus_time_us delta divided by the
+ * wall-clock time of the interval.
+ *
+ * line_modes[] splits the bus-active time by data phase width (1, 2 and 4
+ * lines), so the bandwidth of each mode is line_modes[i].bytes * 1000000 /
+ * line_modes[i].bus_time_us bytes/s. Sending the same payload once per mode
+ * compares them directly.
+ */
+nhal_result_t nhal_esp32_spi_get_stats(struct nhal_spi_context *ctx, struct nhal_spi_stats *stats);
+
+nhal_result_t nhal_esp32_spi_reset_stats(struct nhal_spi_context *ctx);
+
+/**
+ * @brief Holds the context and the SPI bus for a burst of transfers.
+ *
+ * Until the matching nhal_esp32_spi_release(), NHAL SPI calls from the
+ * calling task skip the context mutex and the driver's per-transaction bus
+ * acquisition, and other tasks wait. Calls nest.
+ *
+ * The latency of a small register access on the interrupt and polling paths
+ * can be compared from the statistics: run the access with the polling
+ * threshold at 0 and then at least the access size, and compare
+ * total_time_us / transactions with polled_time_us / polled.
+ */
+nhal_result_t nhal_esp32_spi_acquire(struct nhal_spi_context *ctx);
+
+nhal_result_t nhal_esp32_spi_release(struct nhal_spi_context *ctx);
+
+/**
+ * @brief Changes the polling threshold set by impl_config at runtime.
+ */
+nhal_result_t nhal_esp32_spi_set_polling_threshold(struct nhal_spi_context *ctx, uint16_t threshold);
+
+#endif // NHAL_ESP32_SPI_H
@@ -0,0 +1,55 @@
+/**
+ * @file nhal_esp32_spi_bus.h
+ * @brief SPI host shared by several NHAL SPI device contexts.
+ *
+ * By default every struct nhal_spi_context initializes its own SPI host in
+ * nhal_spi_master_set_config(). A context attached to a struct nhal_spi_bus
+ * instead joins a host that was initialized once by
+ * nhal_esp32_spi_bus_init(): its set_config only adds the device, with its
+ * own mode, clock and CS pin (the MOSI/MISO/SCLK pins and DMA settings of its
+ * impl_config are ignored).
+ *
+ * The ESP-IDF driver arbitrates the host between attached devices and keeps
+ * each device's clock and mode registers precomputed, so switching devices
+ * never reinitializes the bus. The bus statistics count device switches.
+ */
+#ifndef NHAL_ESP32_SPI_BUS_H
+#define NHAL_ESP32_SPI_BUS_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_spi_types.h"
+
+struct nhal_spi_bus_config {
+    int mosi_pin;
+    int miso_pin;                       // -1 if unused
+    int sclk_pin;
+    uint8_t data_lines;                 // 1, 2 or 4 (0 for 1), see struct nhal_spi_impl_config
+    int quadwp_pin;                     // D2, data_lines == 4 only
+    int quadhd_pin;                     // D3, data_lines == 4 only
+    bool use_dma;
+    uint32_t max_transfer_sz;           // With DMA, 0 for the IDF default
+};
+
+nhal_result_t nhal_esp32_spi_bus_init(
+    struct nhal_spi_bus *bus,
+    spi_host_device_t spi_bus_id,
+    const struct nhal_spi_bus_config *config
+);
+
+/**
+ * @brief Frees the host. Fails with NHAL_ERR_BUSY while devices are
+ * configured on it.
+ */
+nhal_result_t nhal_esp32_spi_bus_deinit(struct nhal_spi_bus *bus);
+
+/**
+ * @brief Attaches an initialized but not yet configured context to the bus;
+ * call before nhal_spi_master_set_config().
+ */
+nhal_result_t nhal_esp32_spi_bus_attach(struct nhal_spi_bus *bus, struct nhal_spi_context *ctx);
+
+nhal_result_t nhal_esp32_spi_bus_get_stats(struct nhal_spi_bus *bus, struct nhal_spi_bus_stats *stats);
+
+nhal_result_t nhal_esp32_spi_bus_reset_stats(struct nhal_spi_bus *bus);
+
+#endif // NHAL_ESP32_SPI_BUS_H
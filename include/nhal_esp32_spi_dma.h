@@ -0,0 +1,58 @@
+/**
+ * @file nhal_esp32_spi_dma.h
+ * @brief Pool of DMA-capable buffers for zero-copy SPI transfers.
+ *
+ * Buffers are allocated once from MALLOC_CAP_DMA memory, word aligned, and
+ * lent out without blocking. Passing a borrowed buffer to an SPI context
+ * with DMA enabled skips the bounce copy.
+ */
+#ifndef NHAL_ESP32_SPI_DMA_H
+#define NHAL_ESP32_SPI_DMA_H
+
+#include "nhal_esp32_defs.h"
+
+#include "freertos/FreeRTOS.h"
+
+#ifndef NHAL_ESP32_SPI_DMA_POOL_MAX_BUFFERS
+#define NHAL_ESP32_SPI_DMA_POOL_MAX_BUFFERS 8
+#endif
+
+struct nhal_spi_dma_pool_stats {
+    uint32_t borrowed;
+    uint32_t exhausted;             // Borrow attempts with no buffer left
+    uint32_t max_in_use;
+};
+
+struct nhal_spi_dma_pool {
+    uint8_t *buffers[NHAL_ESP32_SPI_DMA_POOL_MAX_BUFFERS];
+    size_t num_buffers;
+    size_t buffer_size;
+    uint32_t in_use;                // Bit per buffer
+    portMUX_TYPE lock;
+    struct nhal_spi_dma_pool_stats stats;
+};
+
+/**
+ * @brief Allocates num_buffers buffers of buffer_size bytes (rounded up to
+ * a multiple of 4). Fails without allocating anything if memory is short.
+ */
+nhal_result_t nhal_esp32_spi_dma_pool_init(struct nhal_spi_dma_pool *pool, size_t num_buffers, size_t buffer_size);
+
+/**
+ * @brief Frees the buffers. Every borrowed buffer must have been returned.
+ */
+nhal_result_t nhal_esp32_spi_dma_pool_deinit(struct nhal_spi_dma_pool *pool);
+
+/**
+ * @brief Lends a buffer of pool->buffer_size bytes; NHAL_ERR_BUSY when all
+ * are in use. Never blocks, so it may be called from any task.
+ */
+nhal_result_t nhal_esp32_spi_dma_pool_borrow(struct nhal_spi_dma_pool *pool, uint8_t **buffer);
+
+nhal_result_t nhal_esp32_spi_dma_pool_return(struct nhal_spi_dma_pool *pool, uint8_t *buffer);
+
+nhal_result_t nhal_esp32_spi_dma_pool_get_stats(struct nhal_spi_dma_pool *pool, struct nhal_spi_dma_pool_stats *stats);
+
+nhal_result_t nhal_esp32_spi_dma_pool_reset_stats(struct nhal_spi_dma_pool *pool);
+
+#endif // NHAL_ESP32_SPI_DMA_H
@@ -0,0 +1,117 @@
+/**
+ * @file nhal_esp32_spi_fb.h
+ * @brief Double-buffered pixel streaming to SPI displays.
+ *
+ * A region of RGB565 pixels is sent in chunks through a pair of
+ * DMA-capable buffers: while the driver clocks out one buffer, the next
+ * chunk is copied (and optionally byte-swapped) into the other, so the CPU
+ * copy overlaps the bus time instead of adding to it.
+ *
+ * The data/command pin is driven from the transaction pre callback, so it
+ * changes exactly when each transaction starts, with no GPIO writes around
+ * the calls. Windows are set with the MIPI DCS column/page address and
+ * memory write commands (0x2A, 0x2B, 0x2C) used by ILI9341, ST7789 and
+ * similar controllers.
+ *
+ * The context needs an impl_config queue_size of at least 2. The bus must
+ * have DMA and a max_transfer_sz of at least the chunk size.
+ *
+ * If waiting for a chunk fails, the call returns the error with the chunk
+ * still queued. The next call (including deinit) first collects it, and
+ * fails the same way without sending anything until it can.
+ */
+#ifndef NHAL_ESP32_SPI_FB_H
+#define NHAL_ESP32_SPI_FB_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_spi_internal.h"
+#include "nhal_spi_types.h"
+
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+
+// Bytes per DMA chunk; must be even and at least 4
+#ifndef NHAL_ESP32_SPI_FB_CHUNK_SIZE
+#define NHAL_ESP32_SPI_FB_CHUNK_SIZE 4096
+#endif
+
+struct nhal_spi_fb_config {
+    gpio_num_t dc_pin;                  // Low for commands, high for parameters and pixels
+    size_t chunk_size;                  // Even and >= 4, 0 for NHAL_ESP32_SPI_FB_CHUNK_SIZE
+    bool swap_bytes;                    // Send each 16-bit pixel high byte first
+};
+
+struct nhal_spi_fb_stats {
+    uint32_t frames;                    // Regions drawn
+    uint32_t chunks;
+    uint64_t bytes;                     // Pixel bytes sent
+    uint64_t frame_time_us;             // Wall time of all draws
+    uint64_t cpu_time_us;               // Part of it spent filling and queuing, not waiting
+    uint32_t max_frame_us;
+};
+
+struct nhal_spi_fb_desc {
+    struct nhal_spi_trans_hook hook;    // Must stay first: trans.user points here
+    spi_transaction_t trans;
+    gpio_num_t dc_pin;
+    uint32_t dc_level;
+    uint64_t submit_us;
+    bool in_flight;
+};
+
+struct nhal_spi_fb {
+    struct nhal_spi_context *ctx;
+    struct nhal_spi_fb_config config;
+    bool is_initialized;
+    uint8_t *buffers[2];
+    struct nhal_spi_fb_desc descs[2];
+    portMUX_TYPE stats_lock;
+    struct nhal_spi_fb_stats stats;
+};
+
+/**
+ * @brief Allocates the two chunk buffers and configures the D/C pin as an
+ * output. The context must be configured.
+ */
+nhal_result_t nhal_esp32_spi_fb_init(
+    struct nhal_spi_fb *fb,
+    struct nhal_spi_context *ctx,
+    const struct nhal_spi_fb_config *config
+);
+
+nhal_result_t nhal_esp32_spi_fb_deinit(struct nhal_spi_fb *fb);
+
+/**
+ * @brief Sends a command byte followed by up to chunk_size parameter bytes.
+ */
+nhal_result_t nhal_esp32_spi_fb_command(
+    struct nhal_spi_fb *fb,
+    uint8_t command,
+    const uint8_t *params, size_t len
+);
+
+/**
+ * @brief Sets the window to w x h pixels at (x, y) and streams the pixels.
+ *
+ * @param pixels First pixel of the region, rows stride pixels apart, so a
+ * region can be taken straight from a larger framebuffer.
+ *
+ * Returns once the last chunk is on the display. The context and bus are
+ * held for the whole region.
+ */
+nhal_result_t nhal_esp32_spi_fb_draw(
+    struct nhal_spi_fb *fb,
+    uint16_t x, uint16_t y,
+    uint16_t w, uint16_t h,
+    const uint16_t *pixels, size_t stride
+);
+
+/**
+ * Frames per second over back-to-back draws is frames * 1000000 /
+ * frame_time_us; cpu_time_us / frames is the CPU time each frame costs.
+ */
+nhal_result_t nhal_esp32_spi_fb_get_stats(struct nhal_spi_fb *fb, struct nhal_spi_fb_stats *stats);
+
+nhal_result_t nhal_esp32_spi_fb_reset_stats(struct nhal_spi_fb *fb);
+
+#endif // NHAL_ESP32_SPI_FB_H
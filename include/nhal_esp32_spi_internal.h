@@ -0,0 +1,80 @@
+/**
+ * @file nhal_esp32_spi_internal.h
+ * @brief Private interface between the NHAL SPI entry points and the ESP32
+ * SPI extensions. It should not be included directly by higher-level
+ * application code.
+ */
+#ifndef NHAL_ESP32_SPI_INTERNAL_H
+#define NHAL_ESP32_SPI_INTERNAL_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_spi_types.h"
+
+#include "driver/spi_master.h"
+
+/**
+ * Every transaction issued on an NHAL SPI device carries one of these in
+ * spi_transaction_t.user. The device pre/post callbacks (ISR context) stamp
+ * the bus-active window and chain to the optional per-transaction hooks.
+ */
+struct nhal_spi_trans_hook {
+    struct nhal_spi_context *ctx;
+    void (*pre)(spi_transaction_t *trans);      // Optional, ISR context
+    void (*post)(spi_transaction_t *trans);     // Optional, ISR context
+    uint8_t data_lines;                         // Data phase width, 0 for 1
+    volatile uint64_t start_us;
+    volatile uint64_t end_us;
+};
+
+/**
+ * @brief Tells whether the calling task holds the bus through
+ * nhal_esp32_spi_acquire().
+ */
+bool nhal_spi_is_bus_owner(struct nhal_spi_context *ctx);
+
+/**
+ * @brief Takes the context mutex within the context timeout, or nothing if
+ * the calling task already owns the bus.
+ */
+BaseType_t nhal_spi_lock(struct nhal_spi_context *ctx);
+
+/**
+ * @brief Accounts one finished transaction; call with the context mutex held.
+ * @param elapsed_us Time the caller spent on the transaction.
+ */
+void nhal_spi_stats_record(
+    struct nhal_spi_context *ctx,
+    size_t len,
+    uint64_t elapsed_us,
+    const struct nhal_spi_trans_hook *hook,
+    nhal_result_t result
+);
+
+/**
+ * @brief Runs one blocking transaction on the context device; call with the
+ * context mutex held. Zero-initialize ext, then set any flags and phases the
+ * transaction needs before the call.
+ */
+nhal_result_t nhal_spi_transmit_ext_locked(
+    struct nhal_spi_context *ctx,
+    spi_transaction_ext_t *ext,
+    const uint8_t *tx_data, uint8_t *rx_data,
+    size_t len_bits
+);
+
+struct nhal_spi_bus_config;
+
+/**
+ * @brief Fills the ESP-IDF bus config for a set of pins, data lines and DMA
+ * settings. Both a context that owns its bus and a shared bus use it.
+ */
+void nhal_spi_bus_config_to_esp(const struct nhal_spi_bus_config *config, spi_bus_config_t *esp_bus_config);
+
+/**
+ * @brief Tells whether every routed data and clock pin of the bus config is
+ * the host's native IOMUX pin, which allows clocks the GPIO matrix cannot
+ * pass.
+ */
+bool nhal_spi_pins_on_iomux(spi_host_device_t host, const spi_bus_config_t *bus_config);
+
+#endif // NHAL_ESP32_SPI_INTERNAL_H
@@ -0,0 +1,119 @@
+/**
+ * @file nhal_esp32_spi_queue.h
+ * @brief Pipelined SPI transactions through the driver's transaction queue.
+ *
+ * Transactions are taken from a preallocated descriptor pool and queued with
+ * spi_device_queue_trans(), so the driver starts each one as soon as the
+ * previous one ends, without the CPU in between. Results are collected later,
+ * in order; an optional callback runs in ISR context as each one finishes.
+ *
+ * The queue holds the context lock from the first submitted transaction
+ * until every result has been collected, so blocking NHAL calls from other
+ * tasks wait meanwhile. A task that owns the bus (nhal_esp32_spi_acquire())
+ * may queue without taking the lock again. Submit and collect from one
+ * task: while transactions are in flight, calls from any other task return
+ * NHAL_ERR_INVALID_ARG. That task must not make blocking calls on the
+ * context itself until it has collected everything, because the driver
+ * would hand them a queued result.
+ *
+ * Buffers must stay valid until their result is collected. With DMA enabled
+ * they should come from DMA-capable memory (see nhal_esp32_spi_dma.h).
+ */
+#ifndef NHAL_ESP32_SPI_QUEUE_H
+#define NHAL_ESP32_SPI_QUEUE_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_spi_internal.h"
+#include "nhal_spi_types.h"
+
+#include "driver/spi_master.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifndef NHAL_ESP32_SPI_QUEUE_MAX_DESCRIPTORS
+#define NHAL_ESP32_SPI_QUEUE_MAX_DESCRIPTORS 8
+#endif
+
+/**
+ * Called in ISR context when a queued transaction has finished on the bus.
+ */
+typedef void (*nhal_spi_queue_callback_t)(uint32_t id, void *user_data);
+
+struct nhal_spi_queue_desc {
+    struct nhal_spi_trans_hook hook;    // Must stay first: trans.user points here
+    spi_transaction_t trans;
+    nhal_spi_queue_callback_t callback;
+    void *user_data;
+    uint32_t id;
+    size_t len;
+    uint64_t submit_us;
+    bool in_use;
+};
+
+struct nhal_spi_queue_result {
+    uint32_t id;
+    nhal_result_t result;
+    void *user_data;
+};
+
+struct nhal_spi_queue_stats {
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t rejected;                  // Submissions refused: no descriptor or driver slot free
+    uint32_t max_in_flight;
+};
+
+struct nhal_spi_queue {
+    struct nhal_spi_context *ctx;
+    size_t depth;                       // Usable descriptors: pool size capped by the driver queue
+    size_t in_flight;
+    uint32_t next_id;
+    bool holds_lock;                    // From the first submit to the last collect
+    bool took_mutex;                    // The lock was not already held through bus ownership
+    TaskHandle_t owner;                 // Task that submitted the transactions in flight
+    struct nhal_spi_queue_desc descs[NHAL_ESP32_SPI_QUEUE_MAX_DESCRIPTORS];
+    portMUX_TYPE stats_lock;
+    struct nhal_spi_queue_stats stats;
+};
+
+/**
+ * @brief Binds a queue to a configured context. The pipeline depth is the
+ * smaller of NHAL_ESP32_SPI_QUEUE_MAX_DESCRIPTORS and the impl_config
+ * queue_size of the context.
+ */
+nhal_result_t nhal_esp32_spi_queue_init(struct nhal_spi_queue *queue, struct nhal_spi_context *ctx);
+
+/**
+ * @brief Queues a full-duplex transaction of len bytes (either buffer may be
+ * NULL). Never blocks: returns NHAL_ERR_BUSY when the pipeline is full.
+ */
+nhal_result_t nhal_esp32_spi_queue_submit(
+    struct nhal_spi_queue *queue,
+    const uint8_t *tx_data, uint8_t *rx_data, size_t len,
+    nhal_spi_queue_callback_t callback, void *user_data,
+    uint32_t *id
+);
+
+/**
+ * @brief Collects the oldest finished transaction, waiting up to timeout_ms.
+ * @return NHAL_ERR_TIMEOUT if none finished in time, NHAL_ERR_INVALID_ARG
+ * if nothing is in flight.
+ */
+nhal_result_t nhal_esp32_spi_queue_collect(
+    struct nhal_spi_queue *queue,
+    nhal_timeout_ms timeout_ms,
+    struct nhal_spi_queue_result *result
+);
+
+/**
+ * @brief Waits for and collects every transaction in flight, each within
+ * the context timeout.
+ * @return The first failing transaction result, or NHAL_OK.
+ */
+nhal_result_t nhal_esp32_spi_queue_drain(struct nhal_spi_queue *queue);
+
+nhal_result_t nhal_esp32_spi_queue_get_stats(struct nhal_spi_queue *queue, struct nhal_spi_queue_stats *stats);
+
+nhal_result_t nhal_esp32_spi_queue_reset_stats(struct nhal_spi_queue *queue);
+
+#endif // NHAL_ESP32_SPI_QUEUE_H
@@ -0,0 +1,125 @@
+/**
+ * @file nhal_esp32_spi_slave.h
+ * @brief SPI slave link with DMA, pre-posted transactions and framing.
+ *
+ * Every transaction clocked by the host exchanges one fixed-size frame in
+ * each direction. A frame starts with a 4-byte header (sequence number and
+ * payload length, both little-endian uint16) followed by the payload; the
+ * rest of the frame is padding. Both sides number their frames, idle ones
+ * included, so the receiver detects lost frames from gaps in the sequence.
+ *
+ * Transactions are posted ahead of time with their transmit frame, up to
+ * the configured depth, and collected in order as the host clocks them.
+ * The optional ready pin goes high when the driver has loaded a posted
+ * transaction and low when the host has clocked it, so the host only
+ * starts a transfer while the slave is ready. Post and collect from the
+ * same task.
+ */
+#ifndef NHAL_ESP32_SPI_SLAVE_H
+#define NHAL_ESP32_SPI_SLAVE_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_pin_types.h"
+
+#include "driver/gpio.h"
+#include "driver/spi_common.h"
+#include "driver/spi_slave.h"
+
+#ifndef NHAL_ESP32_SPI_SLAVE_MAX_DEPTH
+#define NHAL_ESP32_SPI_SLAVE_MAX_DEPTH 4
+#endif
+
+// Default frame size in bytes, header included
+#ifndef NHAL_ESP32_SPI_SLAVE_FRAME_SIZE
+#define NHAL_ESP32_SPI_SLAVE_FRAME_SIZE 1024
+#endif
+
+#define NHAL_ESP32_SPI_SLAVE_HEADER_SIZE 4
+
+struct nhal_spi_slave_config {
+    spi_host_device_t spi_bus_id;
+    int mosi_pin;
+    int miso_pin;
+    int sclk_pin;
+    int cs_pin;
+    uint8_t mode;                       // SPI mode 0..3
+    size_t frame_size;                  // Multiple of 4, > header; 0 for NHAL_ESP32_SPI_SLAVE_FRAME_SIZE
+    size_t depth;                       // Transactions posted at once, 0 for the maximum
+    struct nhal_pin_context *ready_pin; // Configured output, or NULL for none
+};
+
+struct nhal_spi_slave_stats {
+    uint32_t frames_sent;               // Frames clocked out, idle ones included
+    uint32_t frames_received;           // Frames with a valid header
+    uint64_t bytes_sent;                // Payload bytes
+    uint64_t bytes_received;
+    uint32_t frame_errors;              // Bad length or transfer shorter than the frame
+    uint32_t sequence_errors;           // Received sequence numbers out of order
+    uint32_t frames_lost;               // Frames missing from the gaps
+    uint32_t max_posted;                // Most transactions posted at once
+    uint64_t first_done_us;             // Completion of the first and latest collected transactions
+    uint64_t last_done_us;
+};
+
+struct nhal_spi_slave_desc {
+    spi_slave_transaction_t trans;
+    struct nhal_spi_slave *slave;
+    uint8_t *tx;
+    uint8_t *rx;
+    volatile uint64_t done_us;
+};
+
+struct nhal_spi_slave {
+    struct nhal_spi_slave_config config;
+    bool is_running;
+    gpio_num_t ready_gpio;              // GPIO_NUM_NC without a ready pin
+    size_t posted;                      // Transactions with the driver
+    size_t next_post;                   // Descriptor for the next post; results come back in order
+    uint16_t tx_sequence;
+    uint16_t rx_sequence;               // Next expected
+    bool rx_synced;
+    struct nhal_spi_slave_desc descs[NHAL_ESP32_SPI_SLAVE_MAX_DEPTH];
+    portMUX_TYPE stats_lock;
+    struct nhal_spi_slave_stats stats;
+};
+
+/**
+ * @brief Initializes the host in slave mode with DMA and allocates the
+ * frame buffers. Nothing is posted yet.
+ */
+nhal_result_t nhal_esp32_spi_slave_start(struct nhal_spi_slave *slave, const struct nhal_spi_slave_config *config);
+
+nhal_result_t nhal_esp32_spi_slave_stop(struct nhal_spi_slave *slave);
+
+/**
+ * @brief Posts one transaction carrying len payload bytes (0 for an idle
+ * frame). Never blocks: returns NHAL_ERR_BUSY when depth transactions are
+ * already posted.
+ */
+nhal_result_t nhal_esp32_spi_slave_post(struct nhal_spi_slave *slave, const uint8_t *data, size_t len);
+
+/**
+ * @brief Collects the oldest posted transaction, waiting up to timeout_ms,
+ * and copies the received payload into data.
+ *
+ * @param capacity Size of data; must hold frame_size -
+ * NHAL_ESP32_SPI_SLAVE_HEADER_SIZE bytes.
+ * @return NHAL_ERR_TIMEOUT if the host has not clocked it yet,
+ * NHAL_ERR_OTHER for a malformed frame (*len is then 0).
+ */
+nhal_result_t nhal_esp32_spi_slave_collect(
+    struct nhal_spi_slave *slave,
+    nhal_timeout_ms timeout_ms,
+    uint8_t *data, size_t capacity,
+    size_t *len, uint16_t *sequence
+);
+
+/**
+ * Sustained throughput is (bytes_sent + bytes_received) * 1000000 /
+ * (last_done_us - first_done_us) bytes/s of payload.
+ */
+nhal_result_t nhal_esp32_spi_slave_get_stats(struct nhal_spi_slave *slave, struct nhal_spi_slave_stats *stats);
+
+nhal_result_t nhal_esp32_spi_slave_reset_stats(struct nhal_spi_slave *slave);
+
+#endif // NHAL_ESP32_SPI_SLAVE_H
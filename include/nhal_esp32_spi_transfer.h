@@ -0,0 +1,75 @@
+/**
+ * @file nhal_esp32_spi_transfer.h
+ * @brief Scatter-gather SPI transfers under one chip select assertion.
+ *
+ * A transfer is an optional command/address header followed by a list of
+ * transmit, receive and dummy segments. Every segment runs straight from
+ * the caller's buffer as its own driver transaction, and CS is held
+ * asserted from the first segment to the last (SPI_TRANS_CS_KEEP_ACTIVE), so
+ * the device sees one frame. The command and address go out in the
+ * controller's command and address phases of the first segment instead of
+ * being copied in front of the payload, and dummy segments become the dummy
+ * phase of the transaction that follows them.
+ *
+ * The bus stays acquired for the whole transfer (see nhal_esp32_spi_acquire),
+ * so other devices on a shared bus wait until it ends.
+ */
+#ifndef NHAL_ESP32_SPI_TRANSFER_H
+#define NHAL_ESP32_SPI_TRANSFER_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_spi_types.h"
+
+typedef enum {
+    NHAL_SPI_SEGMENT_TX,                // Send tx, discard what comes back
+    NHAL_SPI_SEGMENT_RX,                // Clock in rx, MOSI undefined
+    NHAL_SPI_SEGMENT_TX_RX,             // Full duplex: both buffers, same length
+    NHAL_SPI_SEGMENT_DUMMY,             // Clock dummy_cycles with no data, at most 255 in a row
+} nhal_spi_segment_type_t;
+
+typedef struct {
+    nhal_spi_segment_type_t type;
+    const uint8_t *tx;
+    uint8_t *rx;
+    size_t length;                      // Bytes, for every type but DUMMY
+    uint32_t dummy_cycles;              // DUMMY only
+} nhal_spi_segment_t;
+
+/**
+ * Command and address phases sent ahead of the first segment, and the line
+ * widths of the whole transfer. A width of 0 bits leaves the phase out;
+ * values are sent MSB first.
+ *
+ * Dual and quad transfers need a context configured half-duplex with at
+ * least as many data_lines, and cannot contain TX_RX segments. The command
+ * and address phases run on one line or on as many lines as the data.
+ */
+struct nhal_spi_transfer_header {
+    uint16_t command;
+    uint8_t command_bits;               // 0..16
+    uint64_t address;
+    uint8_t address_bits;               // 0..64
+    uint8_t command_lines;              // 1 or data_lines, 0 for 1
+    uint8_t address_lines;              // 1 or data_lines, 0 for 1; also used by dummy phases
+    uint8_t data_lines;                 // 1, 2 or 4, 0 for 1
+};
+
+/**
+ * @brief Runs the segments in order with CS held asserted throughout.
+ *
+ * @param header Command/address phases, or NULL for none.
+ * @param num_segments May be 0 for a header-only frame (e.g. a flash
+ * write-enable command).
+ *
+ * Each segment is counted in the context statistics as one transaction.
+ * If a segment fails, the frame is ended (CS released) before the bus is,
+ * and the segment's result is returned.
+ */
+nhal_result_t nhal_esp32_spi_transfer(
+    struct nhal_spi_context *ctx,
+    const struct nhal_spi_transfer_header *header,
+    const nhal_spi_segment_t *segments,
+    size_t num_segments
+);
+
+#endif // NHAL_ESP32_SPI_TRANSFER_H
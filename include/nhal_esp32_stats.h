@@ -0,0 +1,31 @@
+/**
+ * @file nhal_esp32_stats.h
+ * @brief Private statistics convention shared by the ESP32 extensions. It
+ * should not be included directly by higher-level application code.
+ *
+ * An object's counters live in one `stats` struct guarded by a
+ * portMUX_TYPE of the object. Writers update the struct inside that
+ * critical section; get_stats copies it and reset_stats zeroes all of it
+ * under the same lock, so a reader never sees a half-applied update or a
+ * half-cleared struct. A reset clears counters only and leaves the
+ * object's state alone; counting restarts from zero at start and after
+ * every reset.
+ */
+#ifndef NHAL_ESP32_STATS_H
+#define NHAL_ESP32_STATS_H
+
+#include <stddef.h>
+
+#include "freertos/FreeRTOS.h"
+
+/**
+ * @brief Copies size bytes of stats out under lock.
+ */
+void nhal_stats_copy(portMUX_TYPE *lock, void *dst, const void *stats, size_t size);
+
+/**
+ * @brief Zeroes size bytes of stats under lock.
+ */
+void nhal_stats_clear(portMUX_TYPE *lock, void *stats, size_t size);
+
+#endif // NHAL_ESP32_STATS_H
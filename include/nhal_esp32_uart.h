@@ -0,0 +1,76 @@
+/**
+ * @file nhal_esp32_uart.h
+ * @brief ESP32-specific extensions to the NHAL UART interface.
+ */
+#ifndef NHAL_ESP32_UART_H
+#define NHAL_ESP32_UART_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_uart_types.h"
+
+// RX FIFO level (of 128) at which RTS is deasserted with hardware flow control
+#ifndef NHAL_ESP32_UART_FLOW_CTRL_THRESH
+#define NHAL_ESP32_UART_FLOW_CTRL_THRESH 122
+#endif
+
+/**
+ * @brief Reports how many received bytes the driver holds.
+ */
+nhal_result_t nhal_esp32_uart_get_available(struct nhal_uart_context *ctx, size_t *available);
+
+/**
+ * @brief Reads up to len bytes, returning as soon as any are available.
+ *
+ * Waits up to timeout_ms for the first byte, then takes whatever else is
+ * already buffered without waiting. Unlike nhal_uart_read(), a short read is
+ * a success; *bytes_read holds the count.
+ *
+ * @return NHAL_ERR_TIMEOUT if nothing arrived (*bytes_read is then 0).
+ */
+nhal_result_t nhal_esp32_uart_read_up_to(
+    struct nhal_uart_context *ctx,
+    uint8_t *data, size_t len,
+    nhal_timeout_ms timeout_ms,
+    size_t *bytes_read
+);
+
+/**
+ * @brief Copies as much of data into the TX FIFO as fits, without waiting.
+ *
+ * *written may be anything from 0 to len; the caller retries the rest later.
+ * Only for ports without a TX ring buffer (impl_config tx_buffer_size 0),
+ * where it is the driver's uart_tx_chars(). Buffered ports return
+ * NHAL_ERR_UNSUPPORTED; they use the queued writer in nhal_esp32_uart_tx.h.
+ */
+nhal_result_t nhal_esp32_uart_try_write(
+    struct nhal_uart_context *ctx,
+    const uint8_t *data, size_t len,
+    size_t *written
+);
+
+/**
+ * @brief Changes the thresholds set by impl_config at runtime; 0 keeps a
+ * value unchanged.
+ *
+ * The driver moves received bytes from the FIFO to its ring buffer when the
+ * FIFO holds rx_full_thresh bytes or the line has been idle for rx_timeout
+ * symbol times. Raising rx_full_thresh lowers the interrupt rate but leaves
+ * less FIFO headroom before an overflow; lowering rx_timeout delivers the
+ * end of a burst sooner.
+ */
+nhal_result_t nhal_esp32_uart_set_rx_thresholds(struct nhal_uart_context *ctx, uint8_t rx_full_thresh, uint8_t rx_timeout);
+
+/**
+ * @brief Copies the line error counters.
+ *
+ * Errors are reported through the driver event queue and counted by the task
+ * that consumes it: the receiver (nhal_esp32_uart_rx_start()), a framer or an
+ * RS-485 link. Without one running nothing is counted, since unread data
+ * events fill the queue and the driver drops the error events behind them.
+ * This call only copies the counters and never touches the queue.
+ */
+nhal_result_t nhal_esp32_uart_get_stats(struct nhal_uart_context *ctx, struct nhal_uart_stats *stats);
+
+nhal_result_t nhal_esp32_uart_reset_stats(struct nhal_uart_context *ctx);
+
+#endif // NHAL_ESP32_UART_H
@@ -0,0 +1,121 @@
+/**
+ * @file nhal_esp32_uart_frame.h
+ * @brief Delimiter-framed UART packets with COBS or SLIP encoding and CRC.
+ *
+ * The UART's pattern detector finds the frame delimiter in hardware (0x00
+ * for COBS, END 0xC0 for SLIP) and the driver records where it sits in the
+ * RX ring buffer, so a frame is read with one driver call and no byte is
+ * scanned in software. The frame is then decoded in place in the framer's
+ * buffer, its CRC trailer is checked with the ROM CRC routines, and the
+ * payload is handed out as a pointer into that buffer.
+ *
+ * On the wire a frame is encode(payload + CRC) followed by the delimiter.
+ * The CRC covers the payload and is appended little-endian: 2 bytes of
+ * esp_rom_crc16_le(0, ...) or 4 bytes of esp_rom_crc32_le(0, ...) (the
+ * standard CRC-32).
+ *
+ * The framer reads the context's event queue (impl_config queue_size must
+ * be non-zero), so it cannot run together with an event-driven receiver.
+ */
+#ifndef NHAL_ESP32_UART_FRAME_H
+#define NHAL_ESP32_UART_FRAME_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_uart_types.h"
+
+// Positions the driver records ahead of the reader; more frames than this
+// arriving between two receive calls forces a resync
+#ifndef NHAL_ESP32_UART_FRAME_PATTERN_QUEUE
+#define NHAL_ESP32_UART_FRAME_PATTERN_QUEUE 16
+#endif
+
+// Pattern detector timing in baud periods, see uart_enable_pattern_det_baud_intr().
+// No idle time is required around the delimiter, so back-to-back frames split.
+#ifndef NHAL_ESP32_UART_FRAME_CHR_TOUT
+#define NHAL_ESP32_UART_FRAME_CHR_TOUT 9
+#endif
+
+#ifndef NHAL_ESP32_UART_FRAME_POST_IDLE
+#define NHAL_ESP32_UART_FRAME_POST_IDLE 0
+#endif
+
+#ifndef NHAL_ESP32_UART_FRAME_PRE_IDLE
+#define NHAL_ESP32_UART_FRAME_PRE_IDLE 0
+#endif
+
+typedef enum {
+    NHAL_UART_FRAME_COBS,
+    NHAL_UART_FRAME_SLIP,
+} nhal_uart_frame_encoding_t;
+
+typedef enum {
+    NHAL_UART_FRAME_CRC_NONE,
+    NHAL_UART_FRAME_CRC16,
+    NHAL_UART_FRAME_CRC32,
+} nhal_uart_frame_crc_t;
+
+struct nhal_uart_framer_config {
+    nhal_uart_frame_encoding_t encoding;
+    nhal_uart_frame_crc_t crc;
+    uint8_t *buffer;                    // Holds one encoded frame; decoded payloads point into it
+    size_t capacity;                    // Longest encoded frame, delimiter included
+};
+
+struct nhal_uart_framer_stats {
+    uint32_t frames;                    // Frames handed out
+    uint64_t bytes;                     // Their payload bytes
+    uint32_t decode_errors;             // Malformed COBS or SLIP, or too short for the CRC
+    uint32_t crc_errors;
+    uint32_t oversize;                  // Frames longer than the buffer, discarded
+    uint32_t resyncs;                   // Input flushed after an overflow or lost delimiter position
+    uint64_t cpu_time_us;               // Reading, decoding and checking, not waiting
+    uint64_t first_frame_us;            // When the first and latest frames were handed out
+    uint64_t last_frame_us;
+};
+
+struct nhal_uart_framer {
+    struct nhal_uart_context *ctx;
+    struct nhal_uart_framer_config config;
+    bool is_running;
+    bool discard_next;                  // The next frame lost its start to a flush
+    portMUX_TYPE stats_lock;
+    struct nhal_uart_framer_stats stats;
+};
+
+/**
+ * @brief Enables pattern detection for the encoding's delimiter and takes
+ * over the context's event queue. Bytes received before the first
+ * delimiter are discarded with it.
+ */
+nhal_result_t nhal_esp32_uart_framer_start(
+    struct nhal_uart_framer *framer,
+    struct nhal_uart_context *ctx,
+    const struct nhal_uart_framer_config *config
+);
+
+nhal_result_t nhal_esp32_uart_framer_stop(struct nhal_uart_framer *framer);
+
+/**
+ * @brief Waits up to timeout_ms for the next valid frame.
+ *
+ * *payload points into the framer buffer and stays valid until the next
+ * receive. Malformed frames are counted and skipped. Call from one task.
+ *
+ * @return NHAL_ERR_TIMEOUT if no valid frame arrived in time.
+ */
+nhal_result_t nhal_esp32_uart_framer_receive(
+    struct nhal_uart_framer *framer,
+    nhal_timeout_ms timeout_ms,
+    const uint8_t **payload, size_t *len
+);
+
+/**
+ * With frames arriving back to back, the frame rate is frames * 1000000 /
+ * (last_frame_us - first_frame_us) and cpu_time_us / frames is the CPU cost
+ * of each frame.
+ */
+nhal_result_t nhal_esp32_uart_framer_get_stats(struct nhal_uart_framer *framer, struct nhal_uart_framer_stats *stats);
+
+nhal_result_t nhal_esp32_uart_framer_reset_stats(struct nhal_uart_framer *framer);
+
+#endif // NHAL_ESP32_UART_FRAME_H
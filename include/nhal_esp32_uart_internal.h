@@ -0,0 +1,28 @@
+/**
+ * @file nhal_esp32_uart_internal.h
+ * @brief Private interface between the NHAL UART entry points and the ESP32
+ * UART extensions. It should not be included directly by higher-level
+ * application code.
+ */
+#ifndef NHAL_ESP32_UART_INTERNAL_H
+#define NHAL_ESP32_UART_INTERNAL_H
+
+#include "nhal_esp32_defs.h"
+
+#include "driver/uart.h"
+
+/**
+ * @brief Adds a driver event taken from the event queue to the context
+ * statistics. Data and pattern events are not counted.
+ */
+void nhal_uart_count_event(struct nhal_uart_context *ctx, uart_event_type_t type);
+
+/**
+ * @brief Makes the caller the only reader of the context's event queue.
+ * @return false if another receiver already reads it.
+ */
+bool nhal_uart_claim_events(struct nhal_uart_context *ctx);
+
+void nhal_uart_release_events(struct nhal_uart_context *ctx);
+
+#endif // NHAL_ESP32_UART_INTERNAL_H
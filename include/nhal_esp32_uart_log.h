@@ -0,0 +1,187 @@
+/**
+ * @file nhal_esp32_uart_log.h
+ * @brief Lock-free multi-producer log sink drained to a UART.
+ *
+ * Producers (tasks on either core and ISRs) reserve space for a record in a
+ * shared byte ring with a single compare-and-swap, fill it in place and
+ * commit it with one release store of its ring position into a commit
+ * array kept beside the ring. Nothing blocks, takes a lock or calls
+ * the driver, so a producer costs a few tens of cycles plus the copy. A
+ * record becomes visible to the drain only as a whole, so records from
+ * concurrent writers never interleave.
+ *
+ * A low-priority drain task wakes every NHAL_ESP32_UART_LOG_DRAIN_PERIOD_MS
+ * (or on nhal_esp32_uart_log_flush()) and writes committed records to the
+ * UART in order. A record reserved but not yet committed holds back the
+ * records behind it until it is.
+ *
+ * Stopping waits for every producer between reserve and commit, so once
+ * nhal_esp32_uart_log_stop() returns nobody touches the storage any more.
+ *
+ * When the ring is full, the sink either refuses the new record
+ * (NHAL_UART_LOG_DROP_NEWEST) or discards the oldest committed records to
+ * make room (NHAL_UART_LOG_DROP_OLDEST). With drop-newest the drain copies
+ * the payloads of a run of committed records into one chunk, frees them and
+ * writes the chunk with a single driver call. With drop-oldest producers may
+ * free records under the drain, so it copies one record at a time and
+ * discards the copy if the record was dropped meanwhile.
+ *
+ * A record is committed when the commit slot of its first 8 ring bytes
+ * holds its ring position. Commit markers live outside the ring because any
+ * 8 bytes of it may be a header or stale payload, and payload could look
+ * like a marker. Whoever frees a record (the drain, or a producer dropping
+ * it) clears its marker with a compare-and-swap, so a marker never outlives
+ * its record and a slot is never mistaken for committed before the commit.
+ */
+#ifndef NHAL_ESP32_UART_LOG_H
+#define NHAL_ESP32_UART_LOG_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_worker.h"
+#include "nhal_uart_types.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Longest record payload; also bounded by half the ring
+#ifndef NHAL_ESP32_UART_LOG_MAX_RECORD
+#define NHAL_ESP32_UART_LOG_MAX_RECORD 256
+#endif
+
+// Drain staging buffer: payload bytes handed to the driver per write
+#ifndef NHAL_ESP32_UART_LOG_DRAIN_CHUNK
+#define NHAL_ESP32_UART_LOG_DRAIN_CHUNK 1024
+#endif
+
+#if NHAL_ESP32_UART_LOG_DRAIN_CHUNK < NHAL_ESP32_UART_LOG_MAX_RECORD
+#error "NHAL_ESP32_UART_LOG_DRAIN_CHUNK must hold the longest record"
+#endif
+
+#ifndef NHAL_ESP32_UART_LOG_DRAIN_PERIOD_MS
+#define NHAL_ESP32_UART_LOG_DRAIN_PERIOD_MS 20
+#endif
+
+#ifndef NHAL_ESP32_UART_LOG_TASK_STACK_SIZE
+#define NHAL_ESP32_UART_LOG_TASK_STACK_SIZE 2048
+#endif
+
+#ifndef NHAL_ESP32_UART_LOG_TASK_PRIORITY
+#define NHAL_ESP32_UART_LOG_TASK_PRIORITY 1
+#endif
+
+typedef enum {
+    NHAL_UART_LOG_DROP_NEWEST,
+    NHAL_UART_LOG_DROP_OLDEST,
+} nhal_uart_log_policy_t;
+
+// Commit slots needed for a ring of storage_size bytes
+#define NHAL_ESP32_UART_LOG_COMMITS(storage_size) ((storage_size) / 8)
+
+struct nhal_uart_log_config {
+    uint8_t *storage;                   // 8-byte aligned
+    size_t storage_size;                // Power of two, at least 64
+    uint32_t *commits;                  // NHAL_ESP32_UART_LOG_COMMITS(storage_size) entries
+    nhal_uart_log_policy_t policy;
+};
+
+// Commit slot value of a slot that holds no committed record
+#define NHAL_UART_LOG_UNCOMMITTED UINT32_MAX
+
+/**
+ * Every record in the ring starts with this header; the payload follows,
+ * padded to 8 bytes.
+ */
+struct nhal_uart_log_header {
+    uint16_t size;                      // Header, payload and padding
+    uint16_t len;                       // Payload bytes, 0 for wrap padding
+};
+
+struct nhal_uart_log_reservation {
+    uint8_t *data;                      // Room for len bytes
+    size_t len;
+    uint32_t position;
+};
+
+struct nhal_uart_log_stats {
+    uint32_t records;                   // Committed by producers
+    uint32_t dropped_newest;            // Refused because the ring was full
+    uint32_t dropped_oldest;            // Discarded unsent to make room
+    uint32_t drained;                   // Written to the UART
+    uint64_t drained_bytes;
+    uint32_t torn;                      // Drain copies discarded because the record was dropped meanwhile
+    uint32_t max_pending;               // Most ring bytes in use, seen by the drain
+};
+
+struct nhal_uart_log {
+    struct nhal_uart_context *ctx;
+    struct nhal_uart_log_config config;
+    uint32_t mask;                      // storage_size - 1
+    size_t max_len;
+    uint32_t head;                      // Reserved up to here; advanced by producers
+    uint32_t tail;                      // Freed up to here; advanced by the drain (and producers with drop-oldest)
+    bool is_running;
+    volatile bool stopping;
+    uint32_t producers;                 // Inside reserve..commit; stop waits for 0
+    uint8_t chunk[NHAL_ESP32_UART_LOG_DRAIN_CHUNK]; // Payloads being sent
+    portMUX_TYPE stats_lock;            // Guards the drain's counters; producers count atomically
+    TaskHandle_t task;
+    StaticTask_t task_struct;
+    StackType_t task_stack[NHAL_ESP32_UART_LOG_TASK_STACK_SIZE];
+    struct nhal_worker_gate gate;       // Only its exit semaphore is used
+    struct nhal_uart_log_stats stats;
+};
+
+nhal_result_t nhal_esp32_uart_log_start(
+    struct nhal_uart_log *log,
+    struct nhal_uart_context *ctx,
+    const struct nhal_uart_log_config *config
+);
+
+/**
+ * @brief Refuses new records, waits for producers still between reserve
+ * and commit, writes out every committed record and stops the drain task.
+ * A reservation that is never committed keeps this call waiting.
+ */
+nhal_result_t nhal_esp32_uart_log_stop(struct nhal_uart_log *log);
+
+/**
+ * @brief Reserves room for a record of up to len bytes. Safe from ISRs.
+ *
+ * The record must be committed soon, even if empty: it holds back every
+ * record reserved after it.
+ *
+ * @return NHAL_ERR_BUSY if the ring is full under drop-newest, or under
+ * drop-oldest when the oldest record is not committed yet.
+ */
+nhal_result_t nhal_esp32_uart_log_reserve(
+    struct nhal_uart_log *log,
+    size_t len,
+    struct nhal_uart_log_reservation *reservation
+);
+
+/**
+ * @brief Publishes a reserved record with its first len bytes (at most the
+ * reserved length). Safe from ISRs. Every successful reserve must be
+ * followed by one successful commit.
+ */
+nhal_result_t nhal_esp32_uart_log_commit(
+    struct nhal_uart_log *log,
+    const struct nhal_uart_log_reservation *reservation,
+    size_t len
+);
+
+/**
+ * @brief Reserves, copies and commits a record. Safe from ISRs.
+ */
+nhal_result_t nhal_esp32_uart_log_write(struct nhal_uart_log *log, const uint8_t *data, size_t len);
+
+/**
+ * @brief Wakes the drain task now instead of at its next period.
+ */
+nhal_result_t nhal_esp32_uart_log_flush(struct nhal_uart_log *log);
+
+nhal_result_t nhal_esp32_uart_log_get_stats(struct nhal_uart_log *log, struct nhal_uart_log_stats *stats);
+
+nhal_result_t nhal_esp32_uart_log_reset_stats(struct nhal_uart_log *log);
+
+#endif // NHAL_ESP32_UART_LOG_H
@@ -0,0 +1,78 @@
+/**
+ * @file nhal_esp32_uart_reader.h
+ * @brief Buffered UART reader with peek/consume spans for parsers.
+ *
+ * The driver's RX ring buffer is private to the driver, so a reader keeps a
+ * caller-supplied buffer that it fills in bulk with
+ * nhal_esp32_uart_read_up_to(). Parsers peek at a contiguous span of the
+ * buffered bytes, decide how much of it they understood and consume that
+ * much. A variable-length message is then parsed straight from the buffer
+ * with one driver call per burst instead of one per byte.
+ *
+ * Unconsumed bytes are moved to the front of the buffer only when a peek
+ * needs more contiguous room than is left behind them. A reader belongs to
+ * one task and should be the only reader of its context.
+ */
+#ifndef NHAL_ESP32_UART_READER_H
+#define NHAL_ESP32_UART_READER_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_uart_types.h"
+
+struct nhal_uart_reader_stats {
+    uint32_t fills;                     // Driver reads that returned data
+    uint64_t bytes;                     // Bytes taken from the driver
+    uint64_t consumed;
+    uint32_t peeks;
+    uint32_t compactions;               // Times unconsumed bytes were moved to the front
+    uint64_t bytes_moved;
+};
+
+struct nhal_uart_reader {
+    struct nhal_uart_context *ctx;
+    uint8_t *buffer;
+    size_t capacity;
+    size_t start;                       // First unconsumed byte
+    size_t end;                         // One past the last buffered byte
+    portMUX_TYPE stats_lock;
+    struct nhal_uart_reader_stats stats;
+};
+
+nhal_result_t nhal_esp32_uart_reader_init(
+    struct nhal_uart_reader *reader,
+    struct nhal_uart_context *ctx,
+    uint8_t *buffer, size_t capacity
+);
+
+/**
+ * @brief Returns a span of all buffered bytes, reading from the driver
+ * until it holds at least min_len of them or timeout_ms has passed.
+ *
+ * With min_len 0 the buffered bytes are returned as they are, and the driver
+ * is only read when there are none. The span stays valid until the next peek.
+ *
+ * @param min_len At most the buffer capacity.
+ * @return NHAL_ERR_TIMEOUT if fewer than min_len bytes are buffered; *data
+ * and *len still describe what is.
+ */
+nhal_result_t nhal_esp32_uart_reader_peek(
+    struct nhal_uart_reader *reader,
+    size_t min_len,
+    nhal_timeout_ms timeout_ms,
+    const uint8_t **data, size_t *len
+);
+
+/**
+ * @brief Drops len bytes from the front of the buffered data.
+ */
+nhal_result_t nhal_esp32_uart_reader_consume(struct nhal_uart_reader *reader, size_t len);
+
+/**
+ * Driver calls per parsed byte is fills / consumed; byte-at-a-time
+ * nhal_uart_read() costs one call (and timeout setup) per byte.
+ */
+nhal_result_t nhal_esp32_uart_reader_get_stats(struct nhal_uart_reader *reader, struct nhal_uart_reader_stats *stats);
+
+nhal_result_t nhal_esp32_uart_reader_reset_stats(struct nhal_uart_reader *reader);
+
+#endif // NHAL_ESP32_UART_READER_H
@@ -0,0 +1,111 @@
+/**
+ * @file nhal_esp32_uart_rs485.h
+ * @brief RS-485 half-duplex links with hardware direction control.
+ *
+ * With impl_config uart_mode set to UART_MODE_RS485_HALF_DUPLEX, the UART
+ * drives the RTS pin as the transceiver's driver enable: high from the
+ * first start bit to the last stop bit, with no GPIO toggled in software
+ * around the writes. flow_ctrl must be UART_HW_FLOWCTRL_DISABLE.
+ *
+ * In the RS-485 modes an impl_config rx_timeout of 0 is replaced by the
+ * Modbus RTU inter-frame gap (nhal_esp32_uart_rs485_gap_symbols()), so the
+ * RX timeout interrupt marks the end of each received frame. A link built
+ * on that receives whole frames, sends replies, reports collisions and
+ * timestamps the turnaround between them.
+ *
+ * The link reads the context's event queue (impl_config queue_size must be
+ * non-zero), so it cannot run together with an event-driven receiver or a
+ * framer. Frames longer than the RX FIFO full threshold should still end
+ * with a partially filled FIFO for the gap to be seen; keep rx_full_thresh
+ * high.
+ */
+#ifndef NHAL_ESP32_UART_RS485_H
+#define NHAL_ESP32_UART_RS485_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_uart_types.h"
+
+struct nhal_uart_rs485_stats {
+    uint32_t frames_received;
+    uint32_t frames_sent;
+    uint32_t collisions;                // Sent frames another driver talked over
+    uint32_t overruns;                  // Received frames longer than the buffer, discarded
+    uint64_t last_rx_end_us;            // When the gap after the latest received frame was detected
+    uint64_t last_tx_start_us;          // When the latest frame was handed to the driver
+    uint64_t last_tx_done_us;           // When its last stop bit had left and DE was released
+    uint32_t last_turnaround_us;        // Gap detected to reply started, for the latest reply
+    uint32_t max_turnaround_us;
+    uint64_t turnaround_total_us;       // Over `turnarounds` replies
+    uint32_t turnarounds;
+};
+
+struct nhal_uart_rs485 {
+    struct nhal_uart_context *ctx;
+    bool is_running;
+    bool replying;                      // A frame was received and not yet answered
+    bool discarding;                    // Dropping input until the next gap
+    size_t pending;                     // Bytes of the frame in progress, still in the driver
+    uint64_t rx_end_us;                 // Gap of the frame being answered; survives a stats reset
+    portMUX_TYPE stats_lock;
+    struct nhal_uart_rs485_stats stats;
+};
+
+/**
+ * @brief The Modbus RTU inter-frame gap in whole symbol (character) times
+ * for a port configuration: 3.5 characters up to 19200 baud, 1750 us above.
+ *
+ * Rounded down: any threshold above the 1.5-character limit inside a frame
+ * works, while rounding up could merge two frames sent exactly 3.5
+ * characters apart.
+ */
+uint8_t nhal_esp32_uart_rs485_gap_symbols(const struct nhal_uart_config *cfg);
+
+/**
+ * @brief Takes over the event queue of a context configured in an RS-485
+ * mode. Input already buffered is discarded.
+ *
+ * @return NHAL_ERR_NOT_CONFIGURED unless the impl_config uart_mode is
+ * UART_MODE_RS485_HALF_DUPLEX or UART_MODE_RS485_COLLISION_DETECT, the modes
+ * in which the driver reports collisions.
+ */
+nhal_result_t nhal_esp32_uart_rs485_start(struct nhal_uart_rs485 *link, struct nhal_uart_context *ctx);
+
+nhal_result_t nhal_esp32_uart_rs485_stop(struct nhal_uart_rs485 *link);
+
+/**
+ * @brief Waits up to timeout_ms for a complete frame, i.e. bytes followed
+ * by an inter-frame gap.
+ *
+ * Bytes stay in the driver's RX buffer until their frame is complete, so a
+ * timeout loses nothing. Frames longer than capacity are discarded.
+ *
+ * @return NHAL_ERR_TIMEOUT if no frame ended in time.
+ */
+nhal_result_t nhal_esp32_uart_rs485_receive(
+    struct nhal_uart_rs485 *link,
+    uint8_t *data, size_t capacity,
+    size_t *len,
+    nhal_timeout_ms timeout_ms
+);
+
+/**
+ * @brief Sends a frame and returns once it has left the line and the
+ * transceiver is released.
+ *
+ * A send that follows a received frame is the reply to it: the time from
+ * the gap detection to the start of the send is recorded as the turnaround.
+ *
+ * @return NHAL_ERR_OTHER if a collision was detected while sending.
+ */
+nhal_result_t nhal_esp32_uart_rs485_send(struct nhal_uart_rs485 *link, const uint8_t *data, size_t len);
+
+/**
+ * The average turnaround is turnaround_total_us / turnarounds. The gap
+ * detection itself comes nhal_esp32_uart_rs485_gap_symbols() character
+ * times after the last received stop bit.
+ */
+nhal_result_t nhal_esp32_uart_rs485_get_stats(struct nhal_uart_rs485 *link, struct nhal_uart_rs485_stats *stats);
+
+nhal_result_t nhal_esp32_uart_rs485_reset_stats(struct nhal_uart_rs485 *link);
+
+#endif // NHAL_ESP32_UART_RS485_H
@@ -0,0 +1,108 @@
+/**
+ * @file nhal_esp32_uart_rx.h
+ * @brief Event-driven UART receive on top of the driver event queue.
+ *
+ * A receiver owns a task that waits on the UART driver's event queue and
+ * hands received bytes to a callback and/or a stream buffer as soon as the
+ * driver reports them: when the RX FIFO reaches its full threshold or the
+ * line has been idle for the RX timeout. Receive latency is therefore
+ * bounded by the RX timeout instead of the size of a caller's read.
+ *
+ * The context must be configured with a non-zero impl_config queue_size,
+ * which makes the driver create its event queue. While a receiver runs,
+ * other readers of the same port would race it for the data. Line errors
+ * go to the context statistics (nhal_esp32_uart_get_stats()).
+ */
+#ifndef NHAL_ESP32_UART_RX_H
+#define NHAL_ESP32_UART_RX_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_uart_types.h"
+#include "nhal_esp32_worker.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/stream_buffer.h"
+
+#ifndef NHAL_ESP32_UART_RX_CHUNK_SIZE
+#define NHAL_ESP32_UART_RX_CHUNK_SIZE 256
+#endif
+
+#ifndef NHAL_ESP32_UART_RX_TASK_STACK_SIZE
+#define NHAL_ESP32_UART_RX_TASK_STACK_SIZE 3072
+#endif
+
+#ifndef NHAL_ESP32_UART_RX_TASK_PRIORITY
+#define NHAL_ESP32_UART_RX_TASK_PRIORITY 10
+#endif
+
+typedef enum {
+    NHAL_UART_RX_EVENT_FIFO_OVERFLOW,   // Hardware FIFO overflowed; buffered input was flushed
+    NHAL_UART_RX_EVENT_BUFFER_FULL,     // Driver ring buffer full; buffered input was flushed
+    NHAL_UART_RX_EVENT_BREAK,
+    NHAL_UART_RX_EVENT_FRAME_ERROR,
+    NHAL_UART_RX_EVENT_PARITY_ERROR,
+    NHAL_UART_RX_EVENT_PATTERN,         // Pattern detected, see uart_pattern_pop_pos()
+} nhal_uart_rx_event_t;
+
+/**
+ * Called from the receiver task with each chunk of received bytes. The data
+ * is only valid during the call.
+ */
+typedef void (*nhal_uart_rx_data_cb_t)(
+    struct nhal_uart_context *ctx,
+    const uint8_t *data, size_t len,
+    void *user_data
+);
+
+/**
+ * Called from the receiver task for line and buffer events. A pattern event
+ * is reported before the data that contains the pattern is read.
+ */
+typedef void (*nhal_uart_rx_event_cb_t)(
+    struct nhal_uart_context *ctx,
+    nhal_uart_rx_event_t event,
+    void *user_data
+);
+
+struct nhal_uart_rx_config {
+    nhal_uart_rx_data_cb_t on_data;     // Optional
+    nhal_uart_rx_event_cb_t on_event;   // Optional
+    void *user_data;
+    StreamBufferHandle_t stream;        // Optional; receives every chunk, never blocks
+};
+
+struct nhal_uart_rx_stats {
+    uint32_t data_events;
+    uint32_t chunks;                    // Deliveries, at most NHAL_ESP32_UART_RX_CHUNK_SIZE bytes each
+    uint64_t bytes;
+    uint64_t stream_dropped;            // Bytes that did not fit into the stream buffer
+    uint32_t patterns;
+};
+
+struct nhal_uart_rx {
+    struct nhal_uart_context *ctx;
+    struct nhal_uart_rx_config config;
+    bool is_running;
+    portMUX_TYPE lock;                  // Guards stats
+    struct nhal_uart_rx_stats stats;
+    uint8_t chunk[NHAL_ESP32_UART_RX_CHUNK_SIZE];
+    TaskHandle_t task;
+    StaticTask_t task_struct;
+    StackType_t task_stack[NHAL_ESP32_UART_RX_TASK_STACK_SIZE];
+    struct nhal_worker_gate gate;       // Only its exit semaphore is used
+};
+
+nhal_result_t nhal_esp32_uart_rx_start(
+    struct nhal_uart_rx *rx,
+    struct nhal_uart_context *ctx,
+    const struct nhal_uart_rx_config *config
+);
+
+nhal_result_t nhal_esp32_uart_rx_stop(struct nhal_uart_rx *rx);
+
+nhal_result_t nhal_esp32_uart_rx_get_stats(struct nhal_uart_rx *rx, struct nhal_uart_rx_stats *stats);
+
+nhal_result_t nhal_esp32_uart_rx_reset_stats(struct nhal_uart_rx *rx);
+
+#endif // NHAL_ESP32_UART_RX_H
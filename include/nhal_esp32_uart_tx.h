@@ -0,0 +1,149 @@
+/**
+ * @file nhal_esp32_uart_tx.h
+ * @brief Queued UART writes with completion when the bytes are on the wire.
+ *
+ * A writer owns a bounded job queue and a worker task. Submitting never
+ * blocks; the worker hands the data to the driver and reports completion
+ * once uart_wait_tx_done() says the TX ring buffer and FIFO have drained,
+ * i.e. the last stop bit has left the pin.
+ *
+ * Jobs that queue up while the line is busy are written back to back and
+ * completed together after a single drain wait, so the line does not idle
+ * between them. A job may gather several buffers (header, payload, CRC),
+ * which are written in order without being copied into one.
+ *
+ * The drain wait is bounded by the context timeout_ms; jobs still on their
+ * way out by then complete with NHAL_ERR_TIMEOUT. Buffers referenced by a
+ * job must stay valid until its completion is reported. Other writers on the
+ * same context interleave with the jobs.
+ */
+#ifndef NHAL_ESP32_UART_TX_H
+#define NHAL_ESP32_UART_TX_H
+
+#include "nhal_esp32_defs.h"
+#include "nhal_uart_types.h"
+#include "nhal_esp32_worker.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#ifndef NHAL_ESP32_UART_TX_QUEUE_DEPTH
+#define NHAL_ESP32_UART_TX_QUEUE_DEPTH 8
+#endif
+
+// Buffers one gather job can reference
+#ifndef NHAL_ESP32_UART_TX_MAX_SEGMENTS
+#define NHAL_ESP32_UART_TX_MAX_SEGMENTS 4
+#endif
+
+#ifndef NHAL_ESP32_UART_TX_TASK_STACK_SIZE
+#define NHAL_ESP32_UART_TX_TASK_STACK_SIZE 3072
+#endif
+
+#ifndef NHAL_ESP32_UART_TX_TASK_PRIORITY
+#define NHAL_ESP32_UART_TX_TASK_PRIORITY 5
+#endif
+
+struct nhal_uart_tx_segment {
+    const uint8_t *data;
+    size_t len;
+};
+
+struct nhal_uart_tx_completion {
+    uint32_t job_id;
+    nhal_result_t result;
+    uint64_t timestamp_us;          // nhal_get_timestamp_microseconds() once drained
+    void *user_data;
+};
+
+typedef void (*nhal_uart_tx_callback_t)(
+    struct nhal_uart_context *ctx,
+    const struct nhal_uart_tx_completion *completion
+);
+
+/**
+ * @brief How a job reports completion. Any combination may be used:
+ * the callback runs first (in the worker task), then `completion` is filled
+ * and `notify_task` receives a task notification.
+ */
+struct nhal_uart_tx_notify {
+    nhal_uart_tx_callback_t callback;
+    void *user_data;
+    TaskHandle_t notify_task;
+    struct nhal_uart_tx_completion *completion;
+};
+
+struct nhal_uart_tx_job {
+    bool stop;                      // Internal: terminates the worker
+    uint32_t job_id;
+    size_t num_segments;
+    struct nhal_uart_tx_segment segments[NHAL_ESP32_UART_TX_MAX_SEGMENTS];
+    struct nhal_uart_tx_notify notify;
+};
+
+struct nhal_uart_tx_stats {
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t failed;                // Completed with a result other than NHAL_OK
+    uint32_t rejected;              // Submissions refused because the queue was full
+    uint32_t max_queued;            // High-water mark of pending jobs
+    uint64_t bytes;
+    uint32_t drains;                // uart_wait_tx_done() calls; completed / drains is the batching factor
+    uint32_t max_batch;             // Most jobs completed by one drain
+};
+
+struct nhal_uart_tx {
+    struct nhal_uart_context *ctx;
+    bool is_running;
+    uint32_t next_job_id;
+    QueueHandle_t queue;
+    StaticQueue_t queue_struct;
+    uint8_t queue_storage[NHAL_ESP32_UART_TX_QUEUE_DEPTH * sizeof(struct nhal_uart_tx_job)];
+    struct nhal_uart_tx_job batch[NHAL_ESP32_UART_TX_QUEUE_DEPTH]; // Worker only
+    TaskHandle_t task;
+    StaticTask_t task_struct;
+    StackType_t task_stack[NHAL_ESP32_UART_TX_TASK_STACK_SIZE];
+    struct nhal_worker_gate gate;   // Serializes submissions against stop
+    portMUX_TYPE lock;              // Guards next_job_id and stats
+    struct nhal_uart_tx_stats stats;
+};
+
+/**
+ * @brief Starts the worker task for a configured UART context.
+ */
+nhal_result_t nhal_esp32_uart_tx_start(struct nhal_uart_tx *tx, struct nhal_uart_context *ctx);
+
+/**
+ * @brief Lets the worker finish every queued job, then stops it.
+ */
+nhal_result_t nhal_esp32_uart_tx_stop(struct nhal_uart_tx *tx);
+
+/**
+ * The submit functions never block: they return NHAL_ERR_BUSY when the queue
+ * is full. On success, *job_id (optional) identifies the job in its
+ * completion.
+ */
+nhal_result_t nhal_esp32_uart_tx_submit_write(
+    struct nhal_uart_tx *tx,
+    const uint8_t *data, size_t len,
+    const struct nhal_uart_tx_notify *notify,
+    uint32_t *job_id
+);
+
+/**
+ * @brief Writes up to NHAL_ESP32_UART_TX_MAX_SEGMENTS buffers in order as
+ * one job. The segment array itself is copied and may be reused at once.
+ */
+nhal_result_t nhal_esp32_uart_tx_submit_writev(
+    struct nhal_uart_tx *tx,
+    const struct nhal_uart_tx_segment *segments, size_t num_segments,
+    const struct nhal_uart_tx_notify *notify,
+    uint32_t *job_id
+);
+
+nhal_result_t nhal_esp32_uart_tx_get_stats(struct nhal_uart_tx *tx, struct nhal_uart_tx_stats *stats);
+
+nhal_result_t nhal_esp32_uart_tx_reset_stats(struct nhal_uart_tx *tx);
+
+#endif // NHAL_ESP32_UART_TX_H
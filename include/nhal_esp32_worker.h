@@ -0,0 +1,65 @@
+/**
+ * @file nhal_esp32_worker.h
+ * @brief Private start/stop handshake shared by the worker tasks of the ESP32
+ * extensions. It should not be included directly by higher-level
+ * application code.
+ *
+ * A gate admits submitters only while it is open and counts those inside,
+ * so stop can close it and know no job is still on its way into the queue.
+ * The worker reports its exit on a binary semaphore owned by the gate
+ * rather than on the stopping task's notification, which the stopper may
+ * also receive from job completions. The stopper then deletes the worker
+ * itself, so once stop returns the kernel no longer references the static
+ * task and stack inside the caller's struct, and both may be reused.
+ */
+#ifndef NHAL_ESP32_WORKER_H
+#define NHAL_ESP32_WORKER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+struct nhal_worker_gate {
+    portMUX_TYPE lock;
+    bool open;                      // Submissions accepted
+    uint32_t inside;                // Submitters between enter and leave
+    SemaphoreHandle_t stopped;      // Given once by the exiting worker
+    StaticSemaphore_t stopped_struct;
+};
+
+/**
+ * @brief Prepares a closed gate; call before the worker task is created.
+ */
+void nhal_worker_gate_init(struct nhal_worker_gate *gate);
+
+void nhal_worker_gate_open(struct nhal_worker_gate *gate);
+
+/**
+ * @brief Admits a submitter. Every successful enter needs a leave.
+ * @return false if the gate is closed.
+ */
+bool nhal_worker_gate_enter(struct nhal_worker_gate *gate);
+
+void nhal_worker_gate_leave(struct nhal_worker_gate *gate);
+
+/**
+ * @brief Refuses new submitters and waits for those inside to leave.
+ */
+void nhal_worker_gate_close(struct nhal_worker_gate *gate);
+
+/**
+ * @brief Reports the calling worker as finished and suspends it for good;
+ * nothing may touch the worker's state afterwards. Never returns.
+ */
+void nhal_worker_exit(struct nhal_worker_gate *gate);
+
+/**
+ * @brief Blocks until the worker has called nhal_worker_exit(), then
+ * deletes it.
+ */
+void nhal_worker_wait_stopped(struct nhal_worker_gate *gate, TaskHandle_t worker);
+
+#endif // NHAL_ESP32_WORKER_H
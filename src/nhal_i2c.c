@@ -1,6 +1,10 @@
 #include "esp_log.h"
 #include "nhal_esp32_defs.h"
 #include "nhal_esp32_helpers.h"
+#include "nhal_esp32_i2c_backend.h"
+#include "nhal_esp32_i2c.h"
+#include "nhal_esp32_i2c_arbiter.h"
+#include "nhal_esp32_stats.h"
 
 #include "nhal_common.h"
 #include "nhal_i2c_types.h"
@@ -8,19 +12,28 @@
 
 #include "esp_err.h"
 
-#include "driver/i2c_types.h"
-#include "driver/i2c.h"
-#include "driver/i2c_master.h"
-
-static void nhal_config_to_esp_config(struct nhal_i2c_config * config ,i2c_config_t * esp_config){
-    esp_config->mode                = I2C_MODE_MASTER;
-    esp_config->sda_io_num          = config->impl_config->sda_io_num;
-    esp_config->scl_io_num          = config->impl_config->scl_io_num;
-    esp_config->sda_pullup_en       = config->impl_config->sda_pullup_en;
-    esp_config->scl_pullup_en       = config->impl_config->scl_pullup_en;
-    esp_config->master.clk_speed    = config->impl_config->clock_speed_hz;
-};
+#include <string.h>
+
+void nhal_i2c_stats_record(struct nhal_i2c_context *ctx, uint64_t start_us, nhal_result_t result){
+    uint32_t elapsed_us = (uint32_t)(nhal_get_timestamp_microseconds() - start_us);
+
+    portENTER_CRITICAL(&ctx->arb_lock);
+    ctx->stats.transactions++;
+    ctx->stats.total_time_us += elapsed_us;
+    if (elapsed_us > ctx->stats.max_time_us) {
+        ctx->stats.max_time_us = elapsed_us;
+    }
+    if (result != NHAL_OK) {
+        ctx->stats.errors++;
+    }
+    portEXIT_CRITICAL(&ctx->arb_lock);
+}
 
+void nhal_i2c_stats_count(struct nhal_i2c_context *ctx, uint32_t *counter){
+    portENTER_CRITICAL(&ctx->arb_lock);
+    (*counter)++;
+    portEXIT_CRITICAL(&ctx->arb_lock);
+}
 
 nhal_result_t nhal_i2c_master_init(struct nhal_i2c_context * ctx){
     if (ctx == NULL) {
@@ -31,15 +44,13 @@ nhal_result_t nhal_i2c_master_init(struct nhal_i2c_context * ctx){
         return NHAL_OK;
     }
 
-    // Create mutex for sync safety
-    ctx->mutex = xSemaphoreCreateMutex();
-    if (ctx->mutex == NULL) {
-        return NHAL_ERR_OTHER;
-    }
+    // Bus ownership is arbitrated rather than guarded by a plain mutex
+    nhal_i2c_arbiter_init(ctx);
 
     ctx->is_initialized = true;
     ctx->is_configured = false;
     ctx->is_driver_installed = false;
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
 
     return NHAL_OK;
 };
@@ -53,61 +64,67 @@ nhal_result_t nhal_i2c_master_deinit(struct nhal_i2c_context *ctx){
         return NHAL_OK;
     }
 
-    BaseType_t mutex_ret_err = xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
-    if(mutex_ret_err == pdTRUE){
-        if (ctx->is_driver_installed) {
-            esp_err_t ret_err = i2c_driver_delete(ctx->i2c_bus_id);
-            if(ret_err != ESP_OK){
-                xSemaphoreGive(ctx->mutex);
-                return nhal_map_esp_err(ret_err);
-            }
-            ctx->is_driver_installed = false;
-        }
-
-        // Clean up mutex and reset state
-        SemaphoreHandle_t mutex_to_delete = ctx->mutex;
-        ctx->is_initialized = false;
-        ctx->mutex = NULL;
-
-        xSemaphoreGive(mutex_to_delete);
-        vSemaphoreDelete(mutex_to_delete);
+    nhal_result_t result = nhal_i2c_bus_acquire(ctx, &nhal_i2c_default_request_attr);
+    if (result != NHAL_OK) {
+        return NHAL_ERR_BUSY;
+    }
 
-        return NHAL_OK;
-    }else{
+    if (ctx->arb_waiting > 0) {
+        // Other tasks are still queued for the bus
+        nhal_i2c_bus_release(ctx);
         return NHAL_ERR_BUSY;
     }
+
+    if (ctx->is_driver_installed) {
+        result = nhal_i2c_backend_uninstall(ctx);
+        if (result != NHAL_OK) {
+            nhal_i2c_bus_release(ctx);
+            return result;
+        }
+    }
+
+    // Reset state and drop the arbitration resources
+    ctx->is_initialized = false;
+    ctx->is_configured = false;
+    nhal_i2c_bus_release(ctx);
+    nhal_i2c_arbiter_deinit(ctx);
+
+    return NHAL_OK;
 };
 
 nhal_result_t nhal_i2c_master_set_config(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config){
+    if (ctx == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
 
-    esp_err_t ret_err;
-    nhal_result_t i2c_result = NHAL_OK;
-    i2c_config_t esp_config = {0};
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
 
-    nhal_config_to_esp_config(config, &esp_config);
+    nhal_result_t i2c_result = NHAL_OK;
 
     // Set timeout from config
     ctx->timeout_ms = config->impl_config->timeout_ms;
 
-    BaseType_t mutex_ret_err = xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
-    if(mutex_ret_err == pdTRUE){
-        ret_err = i2c_param_config(ctx->i2c_bus_id, &esp_config);
-        if(ret_err != ESP_OK){
-            i2c_result = nhal_map_esp_err(ret_err);
-            goto free_mutex_and_ret;
-        };
-
-        ret_err = i2c_driver_install(ctx->i2c_bus_id, I2C_MODE_MASTER, 0, 0, 0);
-        if(ret_err != ESP_OK){
-            i2c_result = nhal_map_esp_err(ret_err);
-            goto free_mutex_and_ret;
-        };
-
-        ctx->is_driver_installed = true;
+    if(nhal_i2c_bus_acquire(ctx, &nhal_i2c_default_request_attr) == NHAL_OK){
+        // Reconfiguring tears down the previous driver instance first
+        if (ctx->is_driver_installed) {
+            ctx->is_configured = false;
+            i2c_result = nhal_i2c_backend_uninstall(ctx);
+            if(i2c_result != NHAL_OK){
+                goto release_bus_and_ret;
+            }
+        }
+
+        i2c_result = nhal_i2c_backend_install(ctx, config);
+        if(i2c_result != NHAL_OK){
+            goto release_bus_and_ret;
+        }
+
         ctx->is_configured = true;
 
-        free_mutex_and_ret:
-            xSemaphoreGive(ctx->mutex);
+        release_bus_and_ret:
+            nhal_i2c_bus_release(ctx);
             return i2c_result;
 
     }else{
@@ -121,8 +138,31 @@ nhal_result_t nhal_i2c_master_get_config(struct nhal_i2c_context *ctx, struct nh
 };
 
 nhal_result_t nhal_i2c_master_write(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const uint8_t *data, size_t len){
+    return nhal_esp32_i2c_write_ex(ctx, dev_address, data, len, &nhal_i2c_default_request_attr);
+};
 
-    if (ctx == NULL) {
+nhal_result_t nhal_i2c_master_read(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, uint8_t *data, size_t len){
+    return nhal_esp32_i2c_read_ex(ctx, dev_address, data, len, &nhal_i2c_default_request_attr);
+};
+
+nhal_result_t nhal_i2c_master_write_read_reg(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *reg_address, size_t reg_len,
+    uint8_t *data, size_t data_len
+){
+    return nhal_esp32_i2c_write_read_reg_ex(
+        ctx, dev_address, reg_address, reg_len, data, data_len, &nhal_i2c_default_request_attr
+    );
+};
+
+nhal_result_t nhal_esp32_i2c_write_ex(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *data, size_t len,
+    const struct nhal_i2c_request_attr *attr
+){
+    if (ctx == NULL || attr == NULL) {
         return NHAL_ERR_INVALID_ARG;
     }
 
@@ -134,33 +174,25 @@ nhal_result_t nhal_i2c_master_write(struct nhal_i2c_context *ctx, nhal_i2c_addre
         return NHAL_ERR_NOT_CONFIGURED;
     }
 
-    uint8_t esp_addr;
-    nhal_result_t addr_result = nhal_i2c_address_to_esp(dev_address, &esp_addr);
-    if (addr_result != NHAL_OK) {
-        return addr_result;
-    }
-
-    BaseType_t mutex_ret_err = xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
-    if(mutex_ret_err == pdTRUE){
-        nhal_result_t i2c_result = nhal_map_esp_err(
-            i2c_master_write_to_device(
-                ctx->i2c_bus_id,
-                esp_addr,
-                data,
-                len,
-                pdMS_TO_TICKS(ctx->timeout_ms)
-            )
-        );
-        xSemaphoreGive(ctx->mutex);
+    nhal_result_t i2c_result = nhal_i2c_bus_acquire(ctx, attr);
+    if (i2c_result != NHAL_OK) {
         return i2c_result;
-    }else{
-        return NHAL_ERR_BUSY;
     }
-};
 
-nhal_result_t nhal_i2c_master_read(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, uint8_t *data, size_t len){
+    uint64_t start_us = nhal_get_timestamp_microseconds();
+    i2c_result = nhal_i2c_backend_write(ctx, dev_address, data, len);
+    nhal_i2c_stats_record(ctx, start_us, i2c_result);
+    nhal_i2c_bus_release(ctx);
+    return i2c_result;
+}
 
-    if (ctx == NULL) {
+nhal_result_t nhal_esp32_i2c_read_ex(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    uint8_t *data, size_t len,
+    const struct nhal_i2c_request_attr *attr
+){
+    if (ctx == NULL || attr == NULL) {
         return NHAL_ERR_INVALID_ARG;
     }
 
@@ -172,46 +204,31 @@ nhal_result_t nhal_i2c_master_read(struct nhal_i2c_context *ctx, nhal_i2c_addres
         return NHAL_ERR_NOT_CONFIGURED;
     }
 
-    uint8_t esp_addr;
-    nhal_result_t addr_result = nhal_i2c_address_to_esp(dev_address, &esp_addr);
-    if (addr_result != NHAL_OK) {
-        return addr_result;
-    }
-
-    BaseType_t mutex_ret_err = xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
-    if(mutex_ret_err == pdTRUE){
-        nhal_result_t i2c_result;
-
-        if (len == 0) {
-            // 0-byte reads are not supported
-            i2c_result = NHAL_ERR_INVALID_ARG;
-        } else {
-            // Normal read operation
-            i2c_result = nhal_map_esp_err(
-                i2c_master_read_from_device(
-                    ctx->i2c_bus_id,
-                    esp_addr,
-                    data,
-                    len,
-                    pdMS_TO_TICKS(ctx->timeout_ms)
-                )
-            );
-        }
+    if (len == 0) {
+        // 0-byte reads are not supported
+        return NHAL_ERR_INVALID_ARG;
+    }
 
-        xSemaphoreGive(ctx->mutex);
+    nhal_result_t i2c_result = nhal_i2c_bus_acquire(ctx, attr);
+    if (i2c_result != NHAL_OK) {
         return i2c_result;
-    }else{
-        return NHAL_ERR_BUSY;
     }
-};
 
-nhal_result_t nhal_i2c_master_write_read_reg(
+    uint64_t start_us = nhal_get_timestamp_microseconds();
+    i2c_result = nhal_i2c_backend_read(ctx, dev_address, data, len);
+    nhal_i2c_stats_record(ctx, start_us, i2c_result);
+    nhal_i2c_bus_release(ctx);
+    return i2c_result;
+}
+
+nhal_result_t nhal_esp32_i2c_write_read_reg_ex(
     struct nhal_i2c_context *ctx,
     nhal_i2c_address_t dev_address,
     const uint8_t *reg_address, size_t reg_len,
-    uint8_t *data, size_t data_len
+    uint8_t *data, size_t data_len,
+    const struct nhal_i2c_request_attr *attr
 ){
-    if (ctx == NULL) {
+    if (ctx == NULL || attr == NULL) {
         return NHAL_ERR_INVALID_ARG;
     }
 
@@ -223,28 +240,40 @@ nhal_result_t nhal_i2c_master_write_read_reg(
         return NHAL_ERR_NOT_CONFIGURED;
     }
 
-    uint8_t esp_addr;
-    nhal_result_t addr_result = nhal_i2c_address_to_esp(dev_address, &esp_addr);
-    if (addr_result != NHAL_OK) {
-        return addr_result;
-    }
-
-    BaseType_t mutex_ret_err = xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
-    if(mutex_ret_err == pdTRUE){
-        nhal_result_t i2c_result = nhal_map_esp_err(
-            i2c_master_write_read_device(
-                ctx->i2c_bus_id,
-                esp_addr,
-                reg_address,
-                reg_len,
-                data,
-                data_len,
-                pdMS_TO_TICKS(ctx->timeout_ms)
-            )
-        );
-        xSemaphoreGive(ctx->mutex);
+    nhal_result_t i2c_result = nhal_i2c_bus_acquire(ctx, attr);
+    if (i2c_result != NHAL_OK) {
         return i2c_result;
-    }else{
-        return NHAL_ERR_BUSY;
     }
-};
+
+    uint64_t start_us = nhal_get_timestamp_microseconds();
+    i2c_result = nhal_i2c_backend_write_read(ctx, dev_address, reg_address, reg_len, data, data_len);
+    nhal_i2c_stats_record(ctx, start_us, i2c_result);
+    nhal_i2c_bus_release(ctx);
+    return i2c_result;
+}
+
+nhal_result_t nhal_esp32_i2c_get_stats(struct nhal_i2c_context *ctx, struct nhal_i2c_stats *stats){
+    if (ctx == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_copy(&ctx->arb_lock, stats, &ctx->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_reset_stats(struct nhal_i2c_context *ctx){
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_clear(&ctx->arb_lock, &ctx->stats, sizeof(ctx->stats));
+    return NHAL_OK;
+}
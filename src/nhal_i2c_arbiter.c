@@ -0,0 +1,344 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_i2c_backend.h"
+#include "nhal_esp32_i2c_arbiter.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_i2c_types.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include <string.h>
+
+const struct nhal_i2c_request_attr nhal_i2c_default_request_attr = {
+    .priority = NHAL_I2C_PRIORITY_NORMAL,
+    .deadline_us = 0,
+};
+
+// Rounds up: pdMS_TO_TICKS() truncates, so a deadline closer than one tick
+// would not wait at all on a contended bus
+static TickType_t nhal_arb_us_to_ticks(uint64_t us){
+    uint64_t ticks = (us * configTICK_RATE_HZ + 999999) / 1000000;
+    return (ticks < portMAX_DELAY) ? (TickType_t)ticks : portMAX_DELAY - 1;
+}
+
+void nhal_i2c_arbiter_init(struct nhal_i2c_context *ctx){
+    portMUX_INITIALIZE(&ctx->arb_lock);
+    ctx->bus_owned = false;
+    ctx->arb_waiting = 0;
+    ctx->arb_owner = NULL;
+    ctx->arb_boost_lock = xSemaphoreCreateMutexStatic(&ctx->arb_boost_lock_buffer);
+
+    for (size_t i = 0; i < NHAL_ESP32_I2C_ARB_MAX_WAITERS; ++i) {
+        struct nhal_i2c_arb_waiter *waiter = &ctx->arb_waiters[i];
+        waiter->wake = xSemaphoreCreateBinaryStatic(&waiter->wake_buffer);
+        waiter->in_use = false;
+        waiter->granted = false;
+    }
+
+    memset(ctx->arb_stats, 0, sizeof(ctx->arb_stats));
+}
+
+void nhal_i2c_arbiter_deinit(struct nhal_i2c_context *ctx){
+    if (ctx->arb_boost_lock != NULL) {
+        vSemaphoreDelete(ctx->arb_boost_lock);
+        ctx->arb_boost_lock = NULL;
+    }
+
+    for (size_t i = 0; i < NHAL_ESP32_I2C_ARB_MAX_WAITERS; ++i) {
+        if (ctx->arb_waiters[i].wake != NULL) {
+            vSemaphoreDelete(ctx->arb_waiters[i].wake);
+            ctx->arb_waiters[i].wake = NULL;
+        }
+    }
+}
+
+static void nhal_arb_record(struct nhal_i2c_context *ctx, uint8_t priority, uint64_t wait_us, bool granted){
+    struct nhal_i2c_arb_stats *stats = &ctx->arb_stats[priority];
+
+    if (granted) {
+        stats->acquisitions++;
+        stats->total_wait_us += wait_us;
+        if (wait_us > stats->max_wait_us) {
+            stats->max_wait_us = (uint32_t)wait_us;
+        }
+    } else {
+        stats->timeouts++;
+    }
+}
+
+static bool nhal_arb_more_urgent(const struct nhal_i2c_arb_waiter *a, const struct nhal_i2c_arb_waiter *b, uint64_t now_us){
+    bool a_aged = (now_us - a->enqueued_us) >= NHAL_ESP32_I2C_ARB_AGING_US;
+    bool b_aged = (now_us - b->enqueued_us) >= NHAL_ESP32_I2C_ARB_AGING_US;
+
+    if (a_aged != b_aged) {
+        return a_aged;
+    }
+    if (!a_aged) {
+        if (a->priority != b->priority) {
+            return a->priority > b->priority;
+        }
+        uint64_t a_deadline = a->deadline_us ? a->deadline_us : UINT64_MAX;
+        uint64_t b_deadline = b->deadline_us ? b->deadline_us : UINT64_MAX;
+        if (a_deadline != b_deadline) {
+            return a_deadline < b_deadline;
+        }
+    }
+    return a->enqueued_us < b->enqueued_us;
+}
+
+// The bus is not a FreeRTOS mutex, so a waiter lends its priority to the
+// owner by hand; otherwise mid-priority tasks could preempt a low-priority
+// owner and hold up every waiter without bound
+static void nhal_arb_boost_owner(struct nhal_i2c_context *ctx, UBaseType_t priority){
+    TaskHandle_t owner = NULL;
+
+    xSemaphoreTake(ctx->arb_boost_lock, portMAX_DELAY);
+    portENTER_CRITICAL(&ctx->arb_lock);
+    if (ctx->arb_owner != NULL && ctx->arb_owner_prio < priority) {
+        owner = ctx->arb_owner;
+        ctx->arb_owner_prio = priority;
+    }
+    portEXIT_CRITICAL(&ctx->arb_lock);
+
+    if (owner != NULL) {
+        vTaskPrioritySet(owner, priority);
+    }
+    xSemaphoreGive(ctx->arb_boost_lock);
+}
+
+nhal_result_t nhal_i2c_bus_acquire(struct nhal_i2c_context *ctx, const struct nhal_i2c_request_attr *attr){
+    uint64_t now_us = nhal_get_timestamp_microseconds();
+    uint8_t priority = (attr->priority < NHAL_ESP32_I2C_PRIORITY_CLASSES) ?
+        (uint8_t)attr->priority : (NHAL_ESP32_I2C_PRIORITY_CLASSES - 1);
+
+    if (attr->deadline_us != 0 && attr->deadline_us <= now_us) {
+        portENTER_CRITICAL(&ctx->arb_lock);
+        nhal_arb_record(ctx, priority, 0, false);
+        portEXIT_CRITICAL(&ctx->arb_lock);
+        return NHAL_ERR_TIMEOUT;
+    }
+
+    struct nhal_i2c_arb_waiter *waiter = NULL;
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    UBaseType_t self_priority = uxTaskPriorityGet(NULL);
+
+    portENTER_CRITICAL(&ctx->arb_lock);
+    if (!ctx->bus_owned && ctx->arb_waiting == 0) {
+        // Uncontended fast path
+        ctx->bus_owned = true;
+        ctx->arb_owner = self;
+        ctx->arb_owner_base = self_priority;
+        ctx->arb_owner_prio = self_priority;
+        nhal_arb_record(ctx, priority, 0, true);
+        portEXIT_CRITICAL(&ctx->arb_lock);
+        return NHAL_OK;
+    }
+    for (size_t i = 0; i < NHAL_ESP32_I2C_ARB_MAX_WAITERS; ++i) {
+        if (!ctx->arb_waiters[i].in_use) {
+            waiter = &ctx->arb_waiters[i];
+            break;
+        }
+    }
+    if (waiter == NULL) {
+        nhal_arb_record(ctx, priority, 0, false);
+        portEXIT_CRITICAL(&ctx->arb_lock);
+        return NHAL_ERR_BUSY;
+    }
+    waiter->in_use = true;
+    waiter->granted = false;
+    waiter->priority = priority;
+    waiter->deadline_us = attr->deadline_us;
+    waiter->enqueued_us = now_us;
+    waiter->task = self;
+    waiter->task_priority = self_priority;
+    ctx->arb_waiting++;
+    portEXIT_CRITICAL(&ctx->arb_lock);
+
+    nhal_arb_boost_owner(ctx, self_priority);
+
+    TickType_t wait_ticks = pdMS_TO_TICKS(ctx->timeout_ms);
+    bool deadline_bound = false;
+    if (attr->deadline_us != 0) {
+        TickType_t deadline_ticks = nhal_arb_us_to_ticks(attr->deadline_us - now_us);
+        if (deadline_ticks < wait_ticks) {
+            wait_ticks = deadline_ticks;
+            deadline_bound = true;
+        }
+    }
+
+    BaseType_t woken = xSemaphoreTake(waiter->wake, wait_ticks);
+    uint64_t wait_us = nhal_get_timestamp_microseconds() - now_us;
+
+    portENTER_CRITICAL(&ctx->arb_lock);
+    bool granted = waiter->granted;
+    if (!granted) {
+        waiter->in_use = false;
+        ctx->arb_waiting--;
+    }
+    nhal_arb_record(ctx, priority, wait_us, granted);
+    portEXIT_CRITICAL(&ctx->arb_lock);
+
+    if (!granted) {
+        return deadline_bound ? NHAL_ERR_TIMEOUT : NHAL_ERR_BUSY;
+    }
+
+    if (woken != pdTRUE) {
+        // Granted right as the wait timed out: the wake-up is on its way
+        xSemaphoreTake(waiter->wake, portMAX_DELAY);
+    }
+
+    portENTER_CRITICAL(&ctx->arb_lock);
+    waiter->in_use = false;
+    portEXIT_CRITICAL(&ctx->arb_lock);
+    return NHAL_OK;
+}
+
+void nhal_i2c_bus_release(struct nhal_i2c_context *ctx){
+    // Uncontended fast path: nobody waits, so nobody has lent a priority
+    portENTER_CRITICAL(&ctx->arb_lock);
+    if (ctx->arb_waiting == 0 && ctx->arb_owner_prio == ctx->arb_owner_base) {
+        ctx->bus_owned = false;
+        ctx->arb_owner = NULL;
+        portEXIT_CRITICAL(&ctx->arb_lock);
+        return;
+    }
+    portEXIT_CRITICAL(&ctx->arb_lock);
+
+    uint64_t now_us = nhal_get_timestamp_microseconds();
+    struct nhal_i2c_arb_waiter *next = NULL;
+    TaskHandle_t next_task = NULL;
+    UBaseType_t next_prio = 0;
+    bool next_boosted = false;
+
+    xSemaphoreTake(ctx->arb_boost_lock, portMAX_DELAY);
+    portENTER_CRITICAL(&ctx->arb_lock);
+    for (size_t i = 0; i < NHAL_ESP32_I2C_ARB_MAX_WAITERS; ++i) {
+        struct nhal_i2c_arb_waiter *waiter = &ctx->arb_waiters[i];
+        if (!waiter->in_use || waiter->granted) {
+            continue;
+        }
+        if (next == NULL || nhal_arb_more_urgent(waiter, next, now_us)) {
+            next = waiter;
+        }
+    }
+    UBaseType_t own_base = ctx->arb_owner_base;
+    bool own_boosted = (ctx->arb_owner_prio != own_base);
+    if (next != NULL) {
+        // Ownership passes directly to the waiter; bus_owned stays set
+        next->granted = true;
+        ctx->arb_waiting--;
+        ctx->arb_owner = next->task;
+        ctx->arb_owner_base = next->task_priority;
+        ctx->arb_owner_prio = next->task_priority;
+
+        // Waiters still queued lend their priority to the new owner
+        for (size_t i = 0; i < NHAL_ESP32_I2C_ARB_MAX_WAITERS; ++i) {
+            struct nhal_i2c_arb_waiter *waiter = &ctx->arb_waiters[i];
+            if (waiter->in_use && !waiter->granted && waiter->task_priority > ctx->arb_owner_prio) {
+                ctx->arb_owner_prio = waiter->task_priority;
+            }
+        }
+        next_task = next->task;
+        next_prio = ctx->arb_owner_prio;
+        next_boosted = (next_prio != next->task_priority);
+    } else {
+        ctx->bus_owned = false;
+        ctx->arb_owner = NULL;
+    }
+    portEXIT_CRITICAL(&ctx->arb_lock);
+
+    if (next_boosted) {
+        vTaskPrioritySet(next_task, next_prio);
+    }
+    if (own_boosted) {
+        vTaskPrioritySet(NULL, own_base);
+    }
+    xSemaphoreGive(ctx->arb_boost_lock);
+
+    if (next != NULL) {
+        xSemaphoreGive(next->wake);
+    }
+}
+
+static void nhal_reg_address_advance(uint8_t *reg, size_t reg_len, size_t offset){
+    // Big-endian add with carry
+    for (size_t i = reg_len; i > 0 && offset > 0; --i) {
+        size_t sum = reg[i - 1] + (offset & 0xFF);
+        reg[i - 1] = (uint8_t)sum;
+        offset = (offset >> 8) + (sum >> 8);
+    }
+}
+
+nhal_result_t nhal_esp32_i2c_read_reg_chunked(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *reg_address, size_t reg_len,
+    uint8_t *data, size_t data_len,
+    size_t chunk_size,
+    const struct nhal_i2c_request_attr *attr
+){
+    uint8_t reg[4];
+
+    if (ctx == NULL || reg_address == NULL || data == NULL || data_len == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (reg_len == 0 || reg_len > sizeof(reg)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (chunk_size == 0) {
+        chunk_size = NHAL_ESP32_I2C_ARB_CHUNK_SIZE;
+    }
+
+    size_t offset = 0;
+    while (offset < data_len) {
+        size_t len = data_len - offset;
+        if (len > chunk_size) {
+            len = chunk_size;
+        }
+
+        memcpy(reg, reg_address, reg_len);
+        nhal_reg_address_advance(reg, reg_len, offset);
+
+        // Each chunk re-enters arbitration, so urgent requests run in between
+        nhal_result_t result = nhal_esp32_i2c_write_read_reg_ex(
+            ctx, dev_address, reg, reg_len, &data[offset], len, attr
+        );
+        if (result != NHAL_OK) {
+            return result;
+        }
+        offset += len;
+    }
+
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_get_arb_stats(struct nhal_i2c_context *ctx, struct nhal_i2c_arb_stats *stats){
+    if (ctx == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_copy(&ctx->arb_lock, stats, ctx->arb_stats, sizeof(ctx->arb_stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_reset_arb_stats(struct nhal_i2c_context *ctx){
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_clear(&ctx->arb_lock, ctx->arb_stats, sizeof(ctx->arb_stats));
+    return NHAL_OK;
+}
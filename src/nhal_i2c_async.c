@@ -0,0 +1,298 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_i2c_async.h"
+#include "nhal_esp32_worker.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_i2c_types.h"
+#include "nhal_i2c_master.h"
+#include "nhal_i2c_transfer.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include <string.h>
+
+static nhal_result_t nhal_async_run_job(struct nhal_i2c_context *ctx, struct nhal_i2c_async_job *job){
+    switch (job->op) {
+        case NHAL_I2C_ASYNC_OP_WRITE:
+            return nhal_i2c_master_write(ctx, job->dev_address, job->write.data, job->write.len);
+        case NHAL_I2C_ASYNC_OP_READ:
+            return nhal_i2c_master_read(ctx, job->dev_address, job->read.data, job->read.len);
+        case NHAL_I2C_ASYNC_OP_WRITE_READ_REG:
+            return nhal_i2c_master_write_read_reg(
+                ctx, job->dev_address,
+                job->write_read.reg, job->write_read.reg_len,
+                job->write_read.data, job->write_read.data_len
+            );
+        case NHAL_I2C_ASYNC_OP_TRANSFER:
+            return nhal_i2c_master_perform_transfer(
+                ctx, job->dev_address, job->transfer.ops, job->transfer.num_ops
+            );
+        default:
+            return NHAL_ERR_INVALID_ARG;
+    }
+}
+
+static void nhal_async_worker(void *arg){
+    struct nhal_i2c_async *async = (struct nhal_i2c_async *)arg;
+    struct nhal_i2c_async_job job;
+
+    for (;;) {
+        if (xQueueReceive(async->queue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        if (job.op == NHAL_I2C_ASYNC_OP_STOP) {
+            break;
+        }
+
+        // The bus may be held by synchronous callers, or every arbiter waiter
+        // slot taken; back off so the holder can run, and give up after the
+        // context timeout.
+        uint64_t deadline_us = nhal_get_timestamp_microseconds() + (uint64_t)async->ctx->timeout_ms * 1000;
+        nhal_result_t result = nhal_async_run_job(async->ctx, &job);
+        while (result == NHAL_ERR_BUSY && nhal_get_timestamp_microseconds() < deadline_us) {
+            vTaskDelay(1);
+            result = nhal_async_run_job(async->ctx, &job);
+        }
+
+        struct nhal_i2c_async_completion completion = {
+            .job_id = job.job_id,
+            .result = result,
+            .timestamp_us = nhal_get_timestamp_microseconds(),
+            .user_data = job.notify.user_data,
+        };
+
+        portENTER_CRITICAL(&async->lock);
+        async->stats.completed++;
+        if (result != NHAL_OK) {
+            async->stats.failed++;
+        }
+        portEXIT_CRITICAL(&async->lock);
+
+        if (job.notify.callback != NULL) {
+            job.notify.callback(async->ctx, &completion);
+        }
+        if (job.notify.completion != NULL) {
+            *job.notify.completion = completion;
+        }
+        if (job.notify.notify_task != NULL) {
+            xTaskNotifyGive(job.notify.notify_task);
+        }
+    }
+
+    nhal_worker_exit(&async->gate);
+}
+
+static nhal_result_t nhal_async_submit(struct nhal_i2c_async *async, struct nhal_i2c_async_job *job,
+                                       const struct nhal_i2c_async_notify *notify, uint32_t *job_id){
+    if (!nhal_worker_gate_enter(&async->gate)) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (notify != NULL) {
+        job->notify = *notify;
+    }
+
+    portENTER_CRITICAL(&async->lock);
+    job->job_id = async->next_job_id++;
+    portEXIT_CRITICAL(&async->lock);
+
+    if (xQueueSend(async->queue, job, 0) != pdTRUE) {
+        nhal_worker_gate_leave(&async->gate);
+        portENTER_CRITICAL(&async->lock);
+        async->stats.rejected++;
+        portEXIT_CRITICAL(&async->lock);
+        return NHAL_ERR_BUSY;
+    }
+
+    uint32_t queued = NHAL_ESP32_I2C_ASYNC_QUEUE_DEPTH - uxQueueSpacesAvailable(async->queue);
+    nhal_worker_gate_leave(&async->gate);
+    portENTER_CRITICAL(&async->lock);
+    async->stats.submitted++;
+    if (queued > async->stats.max_queued) {
+        async->stats.max_queued = queued;
+    }
+    portEXIT_CRITICAL(&async->lock);
+
+    if (job_id != NULL) {
+        *job_id = job->job_id;
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_async_start(struct nhal_i2c_async *async, struct nhal_i2c_context *ctx){
+    if (async == NULL || ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    if (async->is_running) {
+        return NHAL_OK;
+    }
+
+    async->ctx = ctx;
+    async->next_job_id = 0;
+    nhal_worker_gate_init(&async->gate);
+    portMUX_INITIALIZE(&async->lock);
+    memset(&async->stats, 0, sizeof(async->stats));
+
+    async->queue = xQueueCreateStatic(
+        NHAL_ESP32_I2C_ASYNC_QUEUE_DEPTH,
+        sizeof(struct nhal_i2c_async_job),
+        async->queue_storage,
+        &async->queue_struct
+    );
+    if (async->queue == NULL) {
+        return NHAL_ERR_OTHER;
+    }
+
+    async->task = xTaskCreateStatic(
+        nhal_async_worker,
+        "nhal_i2c_async",
+        NHAL_ESP32_I2C_ASYNC_TASK_STACK_SIZE,
+        async,
+        NHAL_ESP32_I2C_ASYNC_TASK_PRIORITY,
+        async->task_stack,
+        &async->task_struct
+    );
+    if (async->task == NULL) {
+        vQueueDelete(async->queue);
+        async->queue = NULL;
+        return NHAL_ERR_OTHER;
+    }
+
+    async->is_running = true;
+    nhal_worker_gate_open(&async->gate);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_async_stop(struct nhal_i2c_async *async){
+    if (async == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!async->is_running) {
+        return NHAL_OK;
+    }
+
+    // Refuse new submissions, then queue the stop marker behind pending jobs
+    async->is_running = false;
+    nhal_worker_gate_close(&async->gate);
+
+    struct nhal_i2c_async_job stop_job = { .op = NHAL_I2C_ASYNC_OP_STOP };
+    xQueueSend(async->queue, &stop_job, portMAX_DELAY);
+    nhal_worker_wait_stopped(&async->gate, async->task);
+    async->task = NULL;
+
+    vQueueDelete(async->queue);
+    async->queue = NULL;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_async_submit_write(
+    struct nhal_i2c_async *async,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *data, size_t len,
+    const struct nhal_i2c_async_notify *notify,
+    uint32_t *job_id
+){
+    if (async == NULL || (data == NULL && len > 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_i2c_async_job job = {
+        .op = NHAL_I2C_ASYNC_OP_WRITE,
+        .dev_address = dev_address,
+        .write = { .data = data, .len = len },
+    };
+    return nhal_async_submit(async, &job, notify, job_id);
+}
+
+nhal_result_t nhal_esp32_i2c_async_submit_read(
+    struct nhal_i2c_async *async,
+    nhal_i2c_address_t dev_address,
+    uint8_t *data, size_t len,
+    const struct nhal_i2c_async_notify *notify,
+    uint32_t *job_id
+){
+    if (async == NULL || data == NULL || len == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_i2c_async_job job = {
+        .op = NHAL_I2C_ASYNC_OP_READ,
+        .dev_address = dev_address,
+        .read = { .data = data, .len = len },
+    };
+    return nhal_async_submit(async, &job, notify, job_id);
+}
+
+nhal_result_t nhal_esp32_i2c_async_submit_write_read_reg(
+    struct nhal_i2c_async *async,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *reg_address, size_t reg_len,
+    uint8_t *data, size_t data_len,
+    const struct nhal_i2c_async_notify *notify,
+    uint32_t *job_id
+){
+    if (async == NULL || reg_address == NULL || data == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_i2c_async_job job = {
+        .op = NHAL_I2C_ASYNC_OP_WRITE_READ_REG,
+        .dev_address = dev_address,
+        .write_read = {
+            .reg = reg_address, .reg_len = reg_len,
+            .data = data, .data_len = data_len,
+        },
+    };
+    return nhal_async_submit(async, &job, notify, job_id);
+}
+
+nhal_result_t nhal_esp32_i2c_async_submit_transfer(
+    struct nhal_i2c_async *async,
+    nhal_i2c_address_t dev_address,
+    nhal_i2c_transfer_op_t *ops, size_t num_ops,
+    const struct nhal_i2c_async_notify *notify,
+    uint32_t *job_id
+){
+    if (async == NULL || ops == NULL || num_ops == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_i2c_async_job job = {
+        .op = NHAL_I2C_ASYNC_OP_TRANSFER,
+        .dev_address = dev_address,
+        .transfer = { .ops = ops, .num_ops = num_ops },
+    };
+    return nhal_async_submit(async, &job, notify, job_id);
+}
+
+nhal_result_t nhal_esp32_i2c_async_get_stats(struct nhal_i2c_async *async, struct nhal_i2c_async_stats *stats){
+    if (async == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&async->lock, stats, &async->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_async_reset_stats(struct nhal_i2c_async *async){
+    if (async == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&async->lock, &async->stats, sizeof(async->stats));
+    return NHAL_OK;
+}
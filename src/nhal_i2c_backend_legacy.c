@@ -0,0 +1,251 @@
+#include "nhal_esp32_defs.h"
+
+#if NHAL_ESP32_I2C_BACKEND == NHAL_ESP32_I2C_BACKEND_LEGACY
+
+#include "nhal_esp32_i2c_backend.h"
+#include "nhal_esp32_i2c_prepared.h"
+#include "nhal_esp32_helpers.h"
+
+#include "nhal_i2c_types.h"
+
+#include "esp_err.h"
+#include "driver/i2c.h"
+
+static void nhal_config_to_esp_config(struct nhal_i2c_config * config ,i2c_config_t * esp_config){
+    esp_config->mode                = I2C_MODE_MASTER;
+    esp_config->sda_io_num          = config->impl_config->sda_io_num;
+    esp_config->scl_io_num          = config->impl_config->scl_io_num;
+    esp_config->sda_pullup_en       = config->impl_config->sda_pullup_en;
+    esp_config->scl_pullup_en       = config->impl_config->scl_pullup_en;
+    esp_config->master.clk_speed    = config->impl_config->clock_speed_hz;
+};
+
+nhal_result_t nhal_i2c_backend_install(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config){
+    i2c_config_t esp_config = {0};
+    nhal_config_to_esp_config(config, &esp_config);
+
+    esp_err_t ret_err = i2c_param_config(ctx->i2c_bus_id, &esp_config);
+    if(ret_err != ESP_OK){
+        return nhal_map_esp_err(ret_err);
+    }
+
+    ret_err = i2c_driver_install(ctx->i2c_bus_id, I2C_MODE_MASTER, 0, 0, 0);
+    if(ret_err != ESP_OK){
+        return nhal_map_esp_err(ret_err);
+    }
+
+    ctx->is_driver_installed = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_backend_uninstall(struct nhal_i2c_context *ctx){
+    esp_err_t ret_err = i2c_driver_delete(ctx->i2c_bus_id);
+    if(ret_err != ESP_OK){
+        return nhal_map_esp_err(ret_err);
+    }
+    ctx->is_driver_installed = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_backend_write(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const uint8_t *data, size_t len){
+    uint8_t esp_addr;
+    nhal_result_t addr_result = nhal_i2c_address_to_esp(dev_address, &esp_addr);
+    if (addr_result != NHAL_OK) {
+        return addr_result;
+    }
+
+    return nhal_map_esp_err(
+        i2c_master_write_to_device(
+            ctx->i2c_bus_id,
+            esp_addr,
+            data,
+            len,
+            pdMS_TO_TICKS(ctx->timeout_ms)
+        )
+    );
+}
+
+nhal_result_t nhal_i2c_backend_read(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, uint8_t *data, size_t len){
+    uint8_t esp_addr;
+    nhal_result_t addr_result = nhal_i2c_address_to_esp(dev_address, &esp_addr);
+    if (addr_result != NHAL_OK) {
+        return addr_result;
+    }
+
+    return nhal_map_esp_err(
+        i2c_master_read_from_device(
+            ctx->i2c_bus_id,
+            esp_addr,
+            data,
+            len,
+            pdMS_TO_TICKS(ctx->timeout_ms)
+        )
+    );
+}
+
+nhal_result_t nhal_i2c_backend_write_read(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *reg_address, size_t reg_len,
+    uint8_t *data, size_t data_len
+){
+    uint8_t esp_addr;
+    nhal_result_t addr_result = nhal_i2c_address_to_esp(dev_address, &esp_addr);
+    if (addr_result != NHAL_OK) {
+        return addr_result;
+    }
+
+    return nhal_map_esp_err(
+        i2c_master_write_read_device(
+            ctx->i2c_bus_id,
+            esp_addr,
+            reg_address,
+            reg_len,
+            data,
+            data_len,
+            pdMS_TO_TICKS(ctx->timeout_ms)
+        )
+    );
+}
+
+/**
+ * @brief Fills a command link for both the plain and the prepared path, so
+ * link_builds counts the two alike.
+ */
+static esp_err_t nhal_build_cmd_link(
+    struct nhal_i2c_context *ctx,
+    i2c_cmd_handle_t cmd,
+    uint8_t esp_addr,
+    const nhal_i2c_transfer_op_t *ops,
+    size_t num_ops
+){
+    esp_err_t ret;
+
+    nhal_i2c_stats_count(ctx, &ctx->stats.link_builds);
+
+    for (size_t i = 0; i < num_ops; ++i) {
+        const nhal_i2c_transfer_op_t* op = &ops[i];
+
+        if (!(op->flags & NHAL_I2C_TRANSFER_MSG_NO_START)) {
+            ret = i2c_master_start(cmd);
+            if (ret != ESP_OK) return ret;
+        }
+
+        if (!(op->flags & NHAL_I2C_TRANSFER_MSG_NO_ADDR)) {
+            uint8_t addr_byte = (esp_addr << 1);
+            if (op->type == NHAL_I2C_READ_OP) {
+                addr_byte |= I2C_MASTER_READ;
+            } else {
+                addr_byte |= I2C_MASTER_WRITE;
+            }
+
+            ret = i2c_master_write_byte(cmd, addr_byte, true);
+            if (ret != ESP_OK) return ret;
+        }
+
+        if (op->type == NHAL_I2C_READ_OP) {
+            if (op->read.length > 0) {
+                ret = i2c_master_read(cmd, op->read.buffer, op->read.length, I2C_MASTER_LAST_NACK);
+                if (ret != ESP_OK) return ret;
+            }
+        } else {
+            if (op->write.length > 0) {
+                ret = i2c_master_write(cmd, op->write.bytes, op->write.length, true);
+                if (ret != ESP_OK) return ret;
+            }
+        }
+
+        if (!(op->flags & NHAL_I2C_TRANSFER_MSG_NO_STOP)) {
+            ret = i2c_master_stop(cmd);
+            if (ret != ESP_OK) return ret;
+        }
+    }
+
+    return ESP_OK;
+}
+
+nhal_result_t nhal_i2c_backend_transfer(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    nhal_i2c_transfer_op_t *ops,
+    size_t num_ops
+){
+    uint8_t esp_addr;
+    nhal_result_t addr_result = nhal_i2c_address_to_esp(dev_address, &esp_addr);
+    if (addr_result != NHAL_OK) {
+        return addr_result;
+    }
+
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    if (cmd == NULL) {
+        return NHAL_ERR_OTHER;
+    }
+    // Counts taking this path, not bytes; the driver allocates more per op
+    nhal_i2c_stats_count(ctx, &ctx->stats.heap_allocations);
+
+    esp_err_t ret = nhal_build_cmd_link(ctx, cmd, esp_addr, ops, num_ops);
+    if (ret == ESP_OK) {
+        ret = i2c_master_cmd_begin(ctx->i2c_bus_id, cmd, pdMS_TO_TICKS(ctx->timeout_ms));
+    }
+
+    i2c_cmd_link_delete(cmd);
+    return nhal_map_esp_err(ret);
+}
+
+/**
+ * @brief (Re)builds the descriptor's command link inside its static buffer.
+ */
+static nhal_result_t nhal_rebuild_prepared(struct nhal_i2c_prepared_transfer *prepared){
+    if (prepared->cmd != NULL) {
+        i2c_cmd_link_delete_static(prepared->cmd);
+        prepared->cmd = NULL;
+    }
+
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(prepared->link_buffer, prepared->link_buffer_size);
+    if (cmd == NULL) {
+        return NHAL_ERR_OUT_OF_MEMORY;
+    }
+
+    esp_err_t ret = nhal_build_cmd_link(prepared->ctx, cmd, prepared->esp_addr, prepared->ops, prepared->num_ops);
+    if (ret != ESP_OK) {
+        i2c_cmd_link_delete_static(cmd);
+        return nhal_map_esp_err(ret);
+    }
+
+    prepared->cmd = cmd;
+    prepared->needs_rebuild = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_backend_prepare(struct nhal_i2c_prepared_transfer *prepared){
+    nhal_result_t addr_result = nhal_i2c_address_to_esp(prepared->dev_address, &prepared->esp_addr);
+    if (addr_result != NHAL_OK) {
+        return addr_result;
+    }
+
+    prepared->cmd = NULL;
+    return nhal_rebuild_prepared(prepared);
+}
+
+nhal_result_t nhal_i2c_backend_execute_prepared(struct nhal_i2c_prepared_transfer *prepared){
+    if (prepared->needs_rebuild) {
+        nhal_result_t result = nhal_rebuild_prepared(prepared);
+        if (result != NHAL_OK) {
+            return result;
+        }
+        prepared->stats.rebuilds++;
+    }
+
+    return nhal_map_esp_err(
+        i2c_master_cmd_begin(prepared->ctx->i2c_bus_id, prepared->cmd, pdMS_TO_TICKS(prepared->ctx->timeout_ms))
+    );
+}
+
+void nhal_i2c_backend_release_prepared(struct nhal_i2c_prepared_transfer *prepared){
+    if (prepared->cmd != NULL) {
+        i2c_cmd_link_delete_static(prepared->cmd);
+        prepared->cmd = NULL;
+    }
+}
+
+#endif // NHAL_ESP32_I2C_BACKEND == NHAL_ESP32_I2C_BACKEND_LEGACY
@@ -0,0 +1,296 @@
+#include "nhal_esp32_defs.h"
+
+#if NHAL_ESP32_I2C_BACKEND == NHAL_ESP32_I2C_BACKEND_MASTER_BUS
+
+#include "nhal_esp32_i2c_backend.h"
+#include "nhal_esp32_i2c_prepared.h"
+#include "nhal_esp32_helpers.h"
+
+#include "nhal_i2c_types.h"
+
+#include "esp_err.h"
+#include "esp_idf_version.h"
+#include "driver/i2c_master.h"
+
+// Upper bound on consecutive write segments merged into one transaction
+#define NHAL_I2C_MAX_WRITE_SEGMENTS 4
+
+// Like eviction, an entry the driver refuses to remove keeps its handle so
+// a later uninstall can retry it; the first error is returned
+static nhal_result_t nhal_dev_cache_clear(struct nhal_i2c_context *ctx){
+    esp_err_t first_err = ESP_OK;
+    for (size_t i = 0; i < NHAL_ESP32_I2C_DEV_CACHE_SIZE; ++i) {
+        if (ctx->dev_cache[i].handle == NULL) {
+            continue;
+        }
+        esp_err_t ret_err = i2c_master_bus_rm_device(ctx->dev_cache[i].handle);
+        if (ret_err != ESP_OK) {
+            if (first_err == ESP_OK) {
+                first_err = ret_err;
+            }
+            continue;
+        }
+        ctx->dev_cache[i].handle = NULL;
+    }
+    ctx->dev_cache_next = 0;
+    return nhal_map_esp_err(first_err);
+}
+
+/**
+ * @brief Returns the cached device handle for an address, adding the device
+ * to the bus on first use. When the cache is full the oldest entry is evicted.
+ */
+static nhal_result_t nhal_dev_cache_get(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    i2c_master_dev_handle_t *handle
+){
+    if (dev_address.type == NHAL_I2C_7BIT_ADDR) {
+        for (size_t i = 0; i < NHAL_ESP32_I2C_DEV_CACHE_SIZE; ++i) {
+            struct nhal_i2c_dev_cache_entry *entry = &ctx->dev_cache[i];
+            if (entry->handle != NULL && entry->address_7bit == dev_address.addr.address_7bit) {
+                nhal_i2c_stats_count(ctx, &ctx->stats.dev_cache_hits);
+                *handle = entry->handle;
+                return NHAL_OK;
+            }
+        }
+    }
+
+    uint8_t esp_addr;
+    nhal_result_t addr_result = nhal_i2c_address_to_esp(dev_address, &esp_addr);
+    if (addr_result != NHAL_OK) {
+        return addr_result;
+    }
+
+    struct nhal_i2c_dev_cache_entry *slot = NULL;
+    for (size_t i = 0; i < NHAL_ESP32_I2C_DEV_CACHE_SIZE; ++i) {
+        if (ctx->dev_cache[i].handle == NULL) {
+            slot = &ctx->dev_cache[i];
+            break;
+        }
+    }
+    if (slot == NULL) {
+        // Keep the entry if the driver still holds the device, or it leaks
+        slot = &ctx->dev_cache[ctx->dev_cache_next];
+        esp_err_t ret_err = i2c_master_bus_rm_device(slot->handle);
+        if (ret_err != ESP_OK) {
+            return nhal_map_esp_err(ret_err);
+        }
+        slot->handle = NULL;
+        ctx->dev_cache_next = (ctx->dev_cache_next + 1) % NHAL_ESP32_I2C_DEV_CACHE_SIZE;
+    }
+
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = esp_addr,
+        .scl_speed_hz = ctx->clock_speed_hz,
+    };
+
+    esp_err_t ret_err = i2c_master_bus_add_device(ctx->bus_handle, &dev_config, &slot->handle);
+    if (ret_err != ESP_OK) {
+        slot->handle = NULL;
+        return nhal_map_esp_err(ret_err);
+    }
+
+    slot->address_7bit = esp_addr;
+    nhal_i2c_stats_count(ctx, &ctx->stats.dev_cache_misses);
+    *handle = slot->handle;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_backend_install(struct nhal_i2c_context *ctx, struct nhal_i2c_config *config){
+    i2c_master_bus_config_t bus_config = {
+        .i2c_port = ctx->i2c_bus_id,
+        .sda_io_num = config->impl_config->sda_io_num,
+        .scl_io_num = config->impl_config->scl_io_num,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .flags.enable_internal_pullup = (config->impl_config->sda_pullup_en || config->impl_config->scl_pullup_en),
+    };
+
+    esp_err_t ret_err = i2c_new_master_bus(&bus_config, &ctx->bus_handle);
+    if (ret_err != ESP_OK) {
+        ctx->bus_handle = NULL;
+        return nhal_map_esp_err(ret_err);
+    }
+
+    for (size_t i = 0; i < NHAL_ESP32_I2C_DEV_CACHE_SIZE; ++i) {
+        ctx->dev_cache[i].handle = NULL;
+    }
+    ctx->dev_cache_next = 0;
+    ctx->clock_speed_hz = config->impl_config->clock_speed_hz;
+    ctx->is_driver_installed = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_backend_uninstall(struct nhal_i2c_context *ctx){
+    // The driver refuses to delete a bus that still has devices
+    nhal_result_t result = nhal_dev_cache_clear(ctx);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    esp_err_t ret_err = i2c_del_master_bus(ctx->bus_handle);
+    if (ret_err != ESP_OK) {
+        return nhal_map_esp_err(ret_err);
+    }
+    ctx->bus_handle = NULL;
+    ctx->is_driver_installed = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_backend_write(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, const uint8_t *data, size_t len){
+    i2c_master_dev_handle_t dev;
+    nhal_result_t result = nhal_dev_cache_get(ctx, dev_address, &dev);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    return nhal_map_esp_err(i2c_master_transmit(dev, data, len, ctx->timeout_ms));
+}
+
+nhal_result_t nhal_i2c_backend_read(struct nhal_i2c_context *ctx, nhal_i2c_address_t dev_address, uint8_t *data, size_t len){
+    i2c_master_dev_handle_t dev;
+    nhal_result_t result = nhal_dev_cache_get(ctx, dev_address, &dev);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    return nhal_map_esp_err(i2c_master_receive(dev, data, len, ctx->timeout_ms));
+}
+
+nhal_result_t nhal_i2c_backend_write_read(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const uint8_t *reg_address, size_t reg_len,
+    uint8_t *data, size_t data_len
+){
+    i2c_master_dev_handle_t dev;
+    nhal_result_t result = nhal_dev_cache_get(ctx, dev_address, &dev);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    return nhal_map_esp_err(
+        i2c_master_transmit_receive(dev, reg_address, reg_len, data, data_len, ctx->timeout_ms)
+    );
+}
+
+static bool nhal_op_starts_transaction(const nhal_i2c_transfer_op_t *op){
+    return !(op->flags & (NHAL_I2C_TRANSFER_MSG_NO_START | NHAL_I2C_TRANSFER_MSG_NO_ADDR));
+}
+
+/**
+ * The bus/device driver has no raw command list, so op sequences are mapped
+ * onto its transaction primitives, one STOP-terminated group at a time:
+ *   - read                              -> i2c_master_receive
+ *   - write                             -> i2c_master_transmit
+ *   - write (NO_STOP) + read            -> i2c_master_transmit_receive
+ *   - write (NO_STOP) + write (NO_START | NO_ADDR) ... -> multi-buffer transmit
+ * Any other shape returns NHAL_ERR_UNSUPPORTED.
+ */
+nhal_result_t nhal_i2c_backend_transfer(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    nhal_i2c_transfer_op_t *ops,
+    size_t num_ops
+){
+    i2c_master_dev_handle_t dev;
+    nhal_result_t result = nhal_dev_cache_get(ctx, dev_address, &dev);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    size_t i = 0;
+    while (i < num_ops) {
+        nhal_i2c_transfer_op_t *op = &ops[i];
+        esp_err_t ret;
+
+        if (!nhal_op_starts_transaction(op)) {
+            return NHAL_ERR_UNSUPPORTED;
+        }
+
+        if (op->type == NHAL_I2C_READ_OP) {
+            if (op->flags & NHAL_I2C_TRANSFER_MSG_NO_STOP) {
+                return NHAL_ERR_UNSUPPORTED;
+            }
+            ret = i2c_master_receive(dev, op->read.buffer, op->read.length, ctx->timeout_ms);
+            i += 1;
+        } else if (!(op->flags & NHAL_I2C_TRANSFER_MSG_NO_STOP)) {
+            ret = i2c_master_transmit(dev, op->write.bytes, op->write.length, ctx->timeout_ms);
+            i += 1;
+        } else if (i + 1 < num_ops && ops[i + 1].type == NHAL_I2C_READ_OP) {
+            nhal_i2c_transfer_op_t *rd = &ops[i + 1];
+            if (!nhal_op_starts_transaction(rd) || (rd->flags & NHAL_I2C_TRANSFER_MSG_NO_STOP)) {
+                return NHAL_ERR_UNSUPPORTED;
+            }
+            ret = i2c_master_transmit_receive(
+                dev,
+                op->write.bytes, op->write.length,
+                rd->read.buffer, rd->read.length,
+                ctx->timeout_ms
+            );
+            i += 2;
+        } else {
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+            i2c_master_transmit_multi_buffer_info_t segments[NHAL_I2C_MAX_WRITE_SEGMENTS];
+            size_t num_segments = 0;
+            bool stopped = false;
+
+            while (i < num_ops && !stopped) {
+                nhal_i2c_transfer_op_t *seg = &ops[i];
+                if (seg->type == NHAL_I2C_READ_OP || num_segments == NHAL_I2C_MAX_WRITE_SEGMENTS) {
+                    return NHAL_ERR_UNSUPPORTED;
+                }
+                if (num_segments > 0 &&
+                    (seg->flags & (NHAL_I2C_TRANSFER_MSG_NO_START | NHAL_I2C_TRANSFER_MSG_NO_ADDR)) !=
+                    (NHAL_I2C_TRANSFER_MSG_NO_START | NHAL_I2C_TRANSFER_MSG_NO_ADDR)) {
+                    return NHAL_ERR_UNSUPPORTED;
+                }
+                segments[num_segments].write_buffer = seg->write.bytes;
+                segments[num_segments].buffer_size = seg->write.length;
+                num_segments++;
+                stopped = !(seg->flags & NHAL_I2C_TRANSFER_MSG_NO_STOP);
+                i++;
+            }
+            if (!stopped) {
+                return NHAL_ERR_UNSUPPORTED;
+            }
+            ret = i2c_master_multi_buffer_transmit(dev, segments, num_segments, ctx->timeout_ms);
+#else
+            return NHAL_ERR_UNSUPPORTED;
+#endif
+        }
+
+        if (ret != ESP_OK) {
+            return nhal_map_esp_err(ret);
+        }
+    }
+
+    return NHAL_OK;
+}
+
+// The bus/device driver builds its command list inside the driver on every
+// transaction without heap traffic, so a prepared descriptor only needs to
+// keep the op sequence; buffer swaps are picked up on the next execution.
+nhal_result_t nhal_i2c_backend_prepare(struct nhal_i2c_prepared_transfer *prepared){
+    uint8_t esp_addr;
+    nhal_result_t addr_result = nhal_i2c_address_to_esp(prepared->dev_address, &esp_addr);
+    if (addr_result != NHAL_OK) {
+        return addr_result;
+    }
+
+    prepared->needs_rebuild = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_i2c_backend_execute_prepared(struct nhal_i2c_prepared_transfer *prepared){
+    prepared->needs_rebuild = false;
+    return nhal_i2c_backend_transfer(prepared->ctx, prepared->dev_address, prepared->ops, prepared->num_ops);
+}
+
+void nhal_i2c_backend_release_prepared(struct nhal_i2c_prepared_transfer *prepared){
+    (void)prepared;
+}
+
+#endif // NHAL_ESP32_I2C_BACKEND == NHAL_ESP32_I2C_BACKEND_MASTER_BUS
@@ -0,0 +1,229 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_i2c.h"
+#include "nhal_esp32_i2c_async.h"
+#include "nhal_esp32_i2c_group.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_i2c_types.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include <string.h>
+
+static void nhal_group_read_done(struct nhal_i2c_context *ctx, const struct nhal_i2c_async_completion *completion){
+    struct nhal_i2c_group_read *read = (struct nhal_i2c_group_read *)completion->user_data;
+    read->result = completion->result;
+    xSemaphoreGive(read->done);
+}
+
+static uint64_t nhal_group_bus_time(struct nhal_i2c_group *group){
+    uint64_t total_us = 0;
+    for (size_t b = 0; b < group->num_buses; b++) {
+        struct nhal_i2c_stats bus_stats;
+        if (nhal_esp32_i2c_get_stats(group->buses[b], &bus_stats) == NHAL_OK) {
+            total_us += bus_stats.total_time_us;
+        }
+    }
+    return total_us;
+}
+
+nhal_result_t nhal_esp32_i2c_group_init(
+    struct nhal_i2c_group *group,
+    struct nhal_i2c_context *const *buses,
+    size_t num_buses
+){
+    if (group == NULL || buses == NULL || num_buses == 0 || num_buses > NHAL_ESP32_I2C_GROUP_MAX_BUSES) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (group->is_initialized) {
+        return NHAL_OK;
+    }
+
+    for (size_t b = 0; b < num_buses; b++) {
+        if (buses[b] == NULL) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+        for (size_t other = 0; other < b; other++) {
+            if (buses[other]->i2c_bus_id == buses[b]->i2c_bus_id) {
+                return NHAL_ERR_INVALID_ARG;
+            }
+        }
+    }
+
+    memset(group, 0, sizeof(*group));
+    portMUX_INITIALIZE(&group->lock);
+
+    for (size_t b = 0; b < num_buses; b++) {
+        nhal_result_t result = nhal_esp32_i2c_async_start(&group->engines[b], buses[b]);
+        if (result != NHAL_OK) {
+            while (b-- > 0) {
+                nhal_esp32_i2c_async_stop(&group->engines[b]);
+            }
+            return result;
+        }
+        group->buses[b] = buses[b];
+    }
+
+    group->num_buses = num_buses;
+    group->is_initialized = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_group_deinit(struct nhal_i2c_group *group){
+    if (group == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!group->is_initialized) {
+        return NHAL_OK;
+    }
+
+    for (size_t b = 0; b < group->num_buses; b++) {
+        nhal_esp32_i2c_async_stop(&group->engines[b]);
+    }
+
+    group->is_initialized = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_group_read_batch(
+    struct nhal_i2c_group *group,
+    struct nhal_i2c_group_read *reads,
+    size_t num_reads
+){
+    if (group == NULL || reads == NULL || num_reads == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!group->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    for (size_t i = 0; i < num_reads; i++) {
+        if (reads[i].bus_index >= group->num_buses) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+    }
+
+    // One counting semaphore for the whole batch; every read gives it once
+    StaticSemaphore_t done_buffer;
+    SemaphoreHandle_t done = xSemaphoreCreateCountingStatic(num_reads, 0, &done_buffer);
+    if (done == NULL) {
+        return NHAL_ERR_OTHER;
+    }
+
+    uint64_t bus_time_before = nhal_group_bus_time(group);
+    uint64_t start_us = nhal_get_timestamp_microseconds();
+
+    size_t cursor[NHAL_ESP32_I2C_GROUP_MAX_BUSES] = {0};
+    size_t submitted = 0;
+    size_t completed = 0;
+    size_t handed_out = 0;
+
+    // Hand the reads out round-robin over the buses so every controller gets
+    // work from the start, whatever the order of the batch.
+    while (handed_out < num_reads) {
+        for (size_t b = 0; b < group->num_buses; b++) {
+            while (cursor[b] < num_reads && reads[cursor[b]].bus_index != b) {
+                cursor[b]++;
+            }
+            if (cursor[b] == num_reads) {
+                continue;
+            }
+
+            struct nhal_i2c_group_read *read = &reads[cursor[b]++];
+            read->done = done;
+            struct nhal_i2c_async_notify notify = {
+                .callback = nhal_group_read_done,
+                .user_data = read,
+            };
+
+            nhal_result_t result;
+            for (;;) {
+                result = nhal_esp32_i2c_async_submit_write_read_reg(
+                    &group->engines[b], read->dev_address,
+                    read->reg_address, read->reg_len,
+                    read->data, read->data_len,
+                    &notify, NULL
+                );
+                if (result != NHAL_ERR_BUSY) {
+                    break;
+                }
+                // Queue full: let one of our reads finish, or yield to others
+                if (completed < submitted) {
+                    xSemaphoreTake(done, portMAX_DELAY);
+                    completed++;
+                } else {
+                    vTaskDelay(1);
+                }
+            }
+
+            if (result == NHAL_OK) {
+                submitted++;
+            } else {
+                read->result = result;
+            }
+            handed_out++;
+        }
+    }
+
+    while (completed < submitted) {
+        xSemaphoreTake(done, portMAX_DELAY);
+        completed++;
+    }
+    vSemaphoreDelete(done);
+
+    uint64_t batch_us = nhal_get_timestamp_microseconds() - start_us;
+    uint64_t bus_us = nhal_group_bus_time(group) - bus_time_before;
+
+    nhal_result_t batch_result = NHAL_OK;
+    uint32_t errors = 0;
+    for (size_t i = 0; i < num_reads; i++) {
+        if (reads[i].result != NHAL_OK) {
+            errors++;
+            if (batch_result == NHAL_OK) {
+                batch_result = reads[i].result;
+            }
+        }
+    }
+
+    portENTER_CRITICAL(&group->lock);
+    group->stats.batches++;
+    group->stats.reads += num_reads;
+    group->stats.errors += errors;
+    group->stats.batch_time_us += batch_us;
+    group->stats.bus_time_us += bus_us;
+    portEXIT_CRITICAL(&group->lock);
+
+    return batch_result;
+}
+
+nhal_result_t nhal_esp32_i2c_group_get_stats(struct nhal_i2c_group *group, struct nhal_i2c_group_stats *stats){
+    if (group == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!group->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_copy(&group->lock, stats, &group->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_group_reset_stats(struct nhal_i2c_group *group){
+    if (group == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!group->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_clear(&group->lock, &group->stats, sizeof(group->stats));
+    return NHAL_OK;
+}
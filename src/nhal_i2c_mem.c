@@ -0,0 +1,326 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_i2c_mem.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_i2c_types.h"
+#include "nhal_i2c_master.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <string.h>
+
+// Errors that polling cannot fix; anything else is taken as a busy device
+static inline bool nhal_mem_is_fatal(nhal_result_t result){
+    return result == NHAL_ERR_INVALID_ARG ||
+           result == NHAL_ERR_NOT_INITIALIZED ||
+           result == NHAL_ERR_NOT_CONFIGURED ||
+           result == NHAL_ERR_UNSUPPORTED;
+}
+
+static nhal_i2c_address_t nhal_mem_device_for(const struct nhal_i2c_mem *mem, uint32_t mem_address){
+    nhal_i2c_address_t device = mem->config.dev_address;
+    if (mem->config.block_bits > 0) {
+        uint32_t block = mem_address >> (8 * mem->config.addr_width);
+        device.addr.address_7bit |= (uint8_t)(block & ((1u << mem->config.block_bits) - 1));
+    }
+    return device;
+}
+
+static size_t nhal_mem_put_word_address(const struct nhal_i2c_mem *mem, uint32_t mem_address, uint8_t *frame){
+    if (mem->config.addr_width == 2) {
+        frame[0] = (uint8_t)(mem_address >> 8);
+        frame[1] = (uint8_t)mem_address;
+    } else {
+        frame[0] = (uint8_t)mem_address;
+    }
+    return mem->config.addr_width;
+}
+
+// Bytes from mem_address to the end of its block (one word-address space)
+static uint32_t nhal_mem_block_remaining(const struct nhal_i2c_mem *mem, uint32_t mem_address){
+    uint32_t block_size = 1u << (8 * mem->config.addr_width);
+    return block_size - (mem_address & (block_size - 1));
+}
+
+static void nhal_mem_add_write_time(struct nhal_i2c_mem *mem, uint64_t start_us){
+    uint64_t elapsed_us = nhal_get_timestamp_microseconds() - start_us;
+    portENTER_CRITICAL(&mem->stats_lock);
+    mem->stats.write_time_us += elapsed_us;
+    portEXIT_CRITICAL(&mem->stats_lock);
+}
+
+static void nhal_mem_cycle_done(struct nhal_i2c_mem *mem){
+    uint64_t cycle_us = nhal_get_timestamp_microseconds() - mem->cycle_start_us;
+    mem->cycle_pending = false;
+    portENTER_CRITICAL(&mem->stats_lock);
+    mem->stats.write_cycles++;
+    mem->stats.total_cycle_us += cycle_us;
+    if (cycle_us > mem->stats.max_cycle_us) {
+        mem->stats.max_cycle_us = (uint32_t)cycle_us;
+    }
+    portEXIT_CRITICAL(&mem->stats_lock);
+}
+
+/**
+ * Sends one frame. While a write cycle is pending the device NACKs its
+ * address, so the frame itself is the ACK poll: it goes out as soon as the
+ * previous cycle ends.
+ */
+static nhal_result_t nhal_mem_send(struct nhal_i2c_mem *mem, nhal_i2c_address_t device, const uint8_t *frame, size_t len){
+    if (!mem->cycle_pending) {
+        return nhal_i2c_master_write(mem->ctx, device, frame, len);
+    }
+
+    uint32_t interval_us = mem->config.poll_min_us;
+    for (;;) {
+        nhal_result_t result = nhal_i2c_master_write(mem->ctx, device, frame, len);
+        if (result == NHAL_OK) {
+            nhal_mem_cycle_done(mem);
+            return NHAL_OK;
+        }
+
+        if (nhal_mem_is_fatal(result)) {
+            return result;
+        }
+
+        portENTER_CRITICAL(&mem->stats_lock);
+        mem->stats.ack_polls++;
+        portEXIT_CRITICAL(&mem->stats_lock);
+        if (nhal_get_timestamp_microseconds() - mem->cycle_start_us >= mem->config.write_cycle_us) {
+            return NHAL_ERR_TIMEOUT;
+        }
+
+        // Short busy waits: a tick-based sleep would cost more than the cycle
+        nhal_delay_microseconds(interval_us);
+        interval_us *= 2;
+        if (interval_us > mem->config.poll_max_us) {
+            interval_us = mem->config.poll_max_us;
+        }
+    }
+}
+
+static void nhal_mem_page_sent(struct nhal_i2c_mem *mem, nhal_i2c_address_t device){
+    switch (mem->config.cycle_mode) {
+        case NHAL_I2C_MEM_CYCLE_ACK_POLL:
+            mem->cycle_pending = true;
+            mem->cycle_start_us = nhal_get_timestamp_microseconds();
+            mem->last_device = device;
+            break;
+        case NHAL_I2C_MEM_CYCLE_FIXED_DELAY:
+            mem->cycle_start_us = nhal_get_timestamp_microseconds();
+            nhal_delay_milliseconds((mem->config.write_cycle_us + 999) / 1000);
+            nhal_mem_cycle_done(mem);
+            break;
+        default:
+            break;
+    }
+}
+
+static nhal_result_t nhal_mem_sync_locked(struct nhal_i2c_mem *mem){
+    if (!mem->cycle_pending) {
+        return NHAL_OK;
+    }
+
+    // Setting the word address is harmless and ACKed only once the cycle ends
+    uint8_t frame[2];
+    size_t len = nhal_mem_put_word_address(mem, 0, frame);
+    return nhal_mem_send(mem, mem->last_device, frame, len);
+}
+
+nhal_result_t nhal_esp32_i2c_mem_init(
+    struct nhal_i2c_mem *mem,
+    struct nhal_i2c_context *ctx,
+    const struct nhal_i2c_mem_config *config
+){
+    if (mem == NULL || ctx == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (config->addr_width < 1 || config->addr_width > 2 || config->block_bits > 3 || config->size_bytes == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (config->page_size > NHAL_ESP32_I2C_MEM_MAX_PAGE_SIZE ||
+        (config->page_size & (config->page_size - 1)) != 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (config->cycle_mode != NHAL_I2C_MEM_CYCLE_NONE && config->write_cycle_us == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (config->block_bits > 0 && config->dev_address.type != NHAL_I2C_7BIT_ADDR) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (config->size_bytes > (1u << (8 * config->addr_width + config->block_bits))) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (mem->is_initialized) {
+        return NHAL_OK;
+    }
+
+    memset(mem, 0, sizeof(*mem));
+    portMUX_INITIALIZE(&mem->stats_lock);
+    mem->mutex = xSemaphoreCreateMutexStatic(&mem->mutex_buffer);
+    if (mem->mutex == NULL) {
+        return NHAL_ERR_OTHER;
+    }
+
+    mem->ctx = ctx;
+    mem->config = *config;
+    if (mem->config.page_size == 0) {
+        mem->config.page_size = NHAL_ESP32_I2C_MEM_MAX_PAGE_SIZE;
+    }
+    if (mem->config.poll_min_us == 0) {
+        mem->config.poll_min_us = NHAL_ESP32_I2C_MEM_POLL_MIN_US;
+    }
+    if (mem->config.poll_max_us == 0) {
+        mem->config.poll_max_us = NHAL_ESP32_I2C_MEM_POLL_MAX_US;
+    }
+    if (mem->config.poll_max_us < mem->config.poll_min_us) {
+        mem->config.poll_max_us = mem->config.poll_min_us;
+    }
+    mem->is_initialized = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_mem_deinit(struct nhal_i2c_mem *mem){
+    if (mem == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!mem->is_initialized) {
+        return NHAL_OK;
+    }
+
+    vSemaphoreDelete(mem->mutex);
+    mem->mutex = NULL;
+    mem->is_initialized = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_mem_write(
+    struct nhal_i2c_mem *mem,
+    uint32_t mem_address,
+    const uint8_t *data, size_t len
+){
+    if (mem == NULL || data == NULL || !mem->is_initialized) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (len == 0 || mem_address >= mem->config.size_bytes || len > mem->config.size_bytes - mem_address) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(mem->mutex, portMAX_DELAY);
+    uint64_t start_us = nhal_get_timestamp_microseconds();
+    nhal_result_t result = NHAL_OK;
+
+    while (len > 0) {
+        // Page size divides the block size, so a page never spans two blocks
+        uint32_t chunk = mem->config.page_size - (mem_address & (mem->config.page_size - 1u));
+        if (chunk > len) {
+            chunk = len;
+        }
+
+        nhal_i2c_address_t device = nhal_mem_device_for(mem, mem_address);
+        size_t header = nhal_mem_put_word_address(mem, mem_address, mem->frame);
+        memcpy(&mem->frame[header], data, chunk);
+
+        result = nhal_mem_send(mem, device, mem->frame, header + chunk);
+        if (result != NHAL_OK) {
+            break;
+        }
+
+        portENTER_CRITICAL(&mem->stats_lock);
+        mem->stats.pages_written++;
+        mem->stats.bytes_written += chunk;
+        portEXIT_CRITICAL(&mem->stats_lock);
+        nhal_mem_page_sent(mem, device);
+
+        mem_address += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+
+    nhal_mem_add_write_time(mem, start_us);
+    xSemaphoreGive(mem->mutex);
+    return result;
+}
+
+nhal_result_t nhal_esp32_i2c_mem_read(
+    struct nhal_i2c_mem *mem,
+    uint32_t mem_address,
+    uint8_t *data, size_t len
+){
+    if (mem == NULL || data == NULL || !mem->is_initialized) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (len == 0 || mem_address >= mem->config.size_bytes || len > mem->config.size_bytes - mem_address) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(mem->mutex, portMAX_DELAY);
+    nhal_result_t result = nhal_mem_sync_locked(mem);
+
+    // Sequential reads wrap inside a block, so split where the block changes
+    while (result == NHAL_OK && len > 0) {
+        uint32_t chunk = nhal_mem_block_remaining(mem, mem_address);
+        if (chunk > len) {
+            chunk = len;
+        }
+
+        uint8_t word_address[2];
+        size_t header = nhal_mem_put_word_address(mem, mem_address, word_address);
+        result = nhal_i2c_master_write_read_reg(
+            mem->ctx, nhal_mem_device_for(mem, mem_address), word_address, header, data, chunk
+        );
+        if (result == NHAL_OK) {
+            portENTER_CRITICAL(&mem->stats_lock);
+            mem->stats.bytes_read += chunk;
+            portEXIT_CRITICAL(&mem->stats_lock);
+            mem_address += chunk;
+            data += chunk;
+            len -= chunk;
+        }
+    }
+
+    xSemaphoreGive(mem->mutex);
+    return result;
+}
+
+nhal_result_t nhal_esp32_i2c_mem_sync(struct nhal_i2c_mem *mem){
+    if (mem == NULL || !mem->is_initialized) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(mem->mutex, portMAX_DELAY);
+    uint64_t start_us = nhal_get_timestamp_microseconds();
+    nhal_result_t result = nhal_mem_sync_locked(mem);
+    nhal_mem_add_write_time(mem, start_us);
+    xSemaphoreGive(mem->mutex);
+    return result;
+}
+
+nhal_result_t nhal_esp32_i2c_mem_get_stats(struct nhal_i2c_mem *mem, struct nhal_i2c_mem_stats *stats){
+    if (mem == NULL || stats == NULL || !mem->is_initialized) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&mem->stats_lock, stats, &mem->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_mem_reset_stats(struct nhal_i2c_mem *mem){
+    if (mem == NULL || !mem->is_initialized) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&mem->stats_lock, &mem->stats, sizeof(mem->stats));
+    return NHAL_OK;
+}
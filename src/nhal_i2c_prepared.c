@@ -0,0 +1,140 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_i2c_backend.h"
+#include "nhal_esp32_i2c_prepared.h"
+
+#include "nhal_common.h"
+#include "nhal_i2c_types.h"
+
+#include <string.h>
+
+nhal_result_t nhal_esp32_i2c_prepare_transfer(
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    const nhal_i2c_transfer_op_t *ops,
+    size_t num_ops,
+    uint8_t *link_buffer,
+    size_t link_buffer_size,
+    struct nhal_i2c_prepared_transfer *prepared
+) {
+    if (ctx == NULL || ops == NULL || prepared == NULL || link_buffer == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (num_ops == 0 || num_ops > NHAL_ESP32_I2C_PREPARED_MAX_OPS) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    memset(prepared, 0, sizeof(*prepared));
+    prepared->ctx = ctx;
+    prepared->dev_address = dev_address;
+    memcpy(prepared->ops, ops, num_ops * sizeof(ops[0]));
+    prepared->num_ops = num_ops;
+    prepared->link_buffer = link_buffer;
+    prepared->link_buffer_size = link_buffer_size;
+
+    nhal_result_t result = nhal_i2c_backend_prepare(prepared);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    prepared->is_prepared = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_prepared_set_write_buffer(
+    struct nhal_i2c_prepared_transfer *prepared,
+    size_t op_index,
+    const uint8_t *bytes,
+    size_t length
+) {
+    if (prepared == NULL || !prepared->is_prepared || op_index >= prepared->num_ops) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_i2c_transfer_op_t *op = &prepared->ops[op_index];
+    if (op->type == NHAL_I2C_READ_OP || (bytes == NULL && length > 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (op->write.bytes != bytes || op->write.length != length) {
+        op->write.bytes = bytes;
+        op->write.length = length;
+        prepared->needs_rebuild = true;
+    }
+
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_prepared_set_read_buffer(
+    struct nhal_i2c_prepared_transfer *prepared,
+    size_t op_index,
+    uint8_t *buffer,
+    size_t length
+) {
+    if (prepared == NULL || !prepared->is_prepared || op_index >= prepared->num_ops) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_i2c_transfer_op_t *op = &prepared->ops[op_index];
+    if (op->type != NHAL_I2C_READ_OP || (buffer == NULL && length > 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (op->read.buffer != buffer || op->read.length != length) {
+        op->read.buffer = buffer;
+        op->read.length = length;
+        prepared->needs_rebuild = true;
+    }
+
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_execute_prepared(struct nhal_i2c_prepared_transfer *prepared) {
+    if (prepared == NULL || !prepared->is_prepared) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_i2c_context *ctx = prepared->ctx;
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    nhal_result_t i2c_result = nhal_i2c_bus_acquire(ctx, &nhal_i2c_default_request_attr);
+    if (i2c_result != NHAL_OK) {
+        return i2c_result;
+    }
+
+    uint64_t start_us = nhal_get_timestamp_microseconds();
+    i2c_result = nhal_i2c_backend_execute_prepared(prepared);
+    nhal_i2c_stats_record(ctx, start_us, i2c_result);
+    prepared->stats.executions++;
+    nhal_i2c_bus_release(ctx);
+    return i2c_result;
+}
+
+nhal_result_t nhal_esp32_i2c_release_prepared(struct nhal_i2c_prepared_transfer *prepared) {
+    if (prepared == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!prepared->is_prepared) {
+        return NHAL_OK;
+    }
+
+    nhal_i2c_backend_release_prepared(prepared);
+    prepared->is_prepared = false;
+    return NHAL_OK;
+}
@@ -0,0 +1,335 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_i2c_regcache.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_i2c_types.h"
+#include "nhal_i2c_master.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <string.h>
+
+static inline bool nhal_bit_get(const uint8_t *bitmap, size_t index){
+    return (bitmap[index / 8] >> (index % 8)) & 1u;
+}
+
+static inline void nhal_bit_set(uint8_t *bitmap, size_t index, bool value){
+    if (value) {
+        bitmap[index / 8] |= (uint8_t)(1u << (index % 8));
+    } else {
+        bitmap[index / 8] &= (uint8_t)~(1u << (index % 8));
+    }
+}
+
+// A register is answered from memory when it holds a value the device does
+// not have yet (dirty) or a valid copy of a cacheable register.
+static inline bool nhal_regcache_in_memory(const struct nhal_i2c_regcache *cache, size_t index){
+    return nhal_bit_get(cache->dirty, index) ||
+           (nhal_bit_get(cache->cacheable, index) && nhal_bit_get(cache->valid, index));
+}
+
+static bool nhal_regcache_range_ok(const struct nhal_i2c_regcache *cache, uint8_t reg, size_t count){
+    return count > 0 &&
+           reg >= cache->first_reg &&
+           (size_t)(reg - cache->first_reg) + count <= cache->num_regs;
+}
+
+static void nhal_regcache_count(struct nhal_i2c_regcache *cache, uint32_t *counter){
+    portENTER_CRITICAL(&cache->stats_lock);
+    (*counter)++;
+    portEXIT_CRITICAL(&cache->stats_lock);
+}
+
+static nhal_result_t nhal_regcache_bus_write(struct nhal_i2c_regcache *cache, size_t index, const uint8_t *values, size_t count){
+    uint8_t burst[1 + NHAL_ESP32_I2C_REGCACHE_MAX_BURST];
+
+    burst[0] = (uint8_t)(cache->first_reg + index);
+    memcpy(&burst[1], values, count);
+    nhal_regcache_count(cache, &cache->stats.bus_writes);
+    return nhal_i2c_master_write(cache->ctx, cache->dev_address, burst, 1 + count);
+}
+
+static nhal_result_t nhal_regcache_read_locked(struct nhal_i2c_regcache *cache, size_t index, uint8_t *values, size_t count){
+    size_t end = index + count;
+    size_t i = index;
+
+    while (i < end) {
+        if (nhal_regcache_in_memory(cache, i)) {
+            values[i - index] = cache->shadow[i];
+            if (nhal_bit_get(cache->cacheable, i)) {
+                nhal_regcache_count(cache, &cache->stats.hits);
+            }
+            i++;
+            continue;
+        }
+
+        // Fetch the whole run of registers missing from memory in one burst
+        size_t run_end = i + 1;
+        while (run_end < end && !nhal_regcache_in_memory(cache, run_end) &&
+               (run_end - i) < NHAL_ESP32_I2C_REGCACHE_MAX_BURST) {
+            run_end++;
+        }
+
+        uint8_t reg_address = (uint8_t)(cache->first_reg + i);
+        nhal_regcache_count(cache, &cache->stats.bus_reads);
+        nhal_result_t result = nhal_i2c_master_write_read_reg(
+            cache->ctx, cache->dev_address, &reg_address, 1, &values[i - index], run_end - i
+        );
+        if (result != NHAL_OK) {
+            return result;
+        }
+
+        for (size_t j = i; j < run_end; ++j) {
+            if (nhal_bit_get(cache->cacheable, j)) {
+                cache->shadow[j] = values[j - index];
+                nhal_bit_set(cache->valid, j, true);
+                nhal_regcache_count(cache, &cache->stats.misses);
+            }
+        }
+        i = run_end;
+    }
+
+    return NHAL_OK;
+}
+
+static nhal_result_t nhal_regcache_write_locked(struct nhal_i2c_regcache *cache, size_t index, const uint8_t *values, size_t count){
+    size_t end = index + count;
+    size_t i = index;
+
+    while (i < end) {
+        if (nhal_bit_get(cache->cacheable, i)) {
+            cache->shadow[i] = values[i - index];
+            nhal_bit_set(cache->valid, i, true);
+            nhal_bit_set(cache->dirty, i, true);
+            i++;
+            continue;
+        }
+
+        // Volatile registers are written through, a run at a time
+        size_t run_end = i + 1;
+        while (run_end < end && !nhal_bit_get(cache->cacheable, run_end) &&
+               (run_end - i) < NHAL_ESP32_I2C_REGCACHE_MAX_BURST) {
+            run_end++;
+        }
+
+        nhal_result_t result = nhal_regcache_bus_write(cache, i, &values[i - index], run_end - i);
+        if (result != NHAL_OK) {
+            return result;
+        }
+
+        for (size_t j = i; j < run_end; ++j) {
+            nhal_bit_set(cache->dirty, j, false);
+        }
+        i = run_end;
+    }
+
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_regcache_init(
+    struct nhal_i2c_regcache *cache,
+    struct nhal_i2c_context *ctx,
+    nhal_i2c_address_t dev_address,
+    uint8_t first_reg,
+    uint8_t num_regs
+){
+    if (cache == NULL || ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (num_regs == 0 || num_regs > NHAL_ESP32_I2C_REGCACHE_MAX_REGS ||
+        (size_t)first_reg + num_regs > 256) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (cache->is_initialized) {
+        return NHAL_OK;
+    }
+
+    memset(cache, 0, sizeof(*cache));
+    portMUX_INITIALIZE(&cache->stats_lock);
+    cache->mutex = xSemaphoreCreateMutexStatic(&cache->mutex_buffer);
+    if (cache->mutex == NULL) {
+        return NHAL_ERR_OTHER;
+    }
+
+    cache->ctx = ctx;
+    cache->dev_address = dev_address;
+    cache->first_reg = first_reg;
+    cache->num_regs = num_regs;
+    cache->is_initialized = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_regcache_deinit(struct nhal_i2c_regcache *cache){
+    if (cache == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!cache->is_initialized) {
+        return NHAL_OK;
+    }
+
+    vSemaphoreDelete(cache->mutex);
+    cache->mutex = NULL;
+    cache->is_initialized = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_regcache_set_cacheable(
+    struct nhal_i2c_regcache *cache,
+    uint8_t reg, size_t count,
+    bool cacheable
+){
+    if (cache == NULL || !cache->is_initialized || !nhal_regcache_range_ok(cache, reg, count)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(cache->mutex, portMAX_DELAY);
+    size_t index = reg - cache->first_reg;
+    for (size_t i = index; i < index + count; ++i) {
+        nhal_bit_set(cache->cacheable, i, cacheable);
+        if (!cacheable && !nhal_bit_get(cache->dirty, i)) {
+            nhal_bit_set(cache->valid, i, false);
+        }
+    }
+    xSemaphoreGive(cache->mutex);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_regcache_read(
+    struct nhal_i2c_regcache *cache,
+    uint8_t reg, uint8_t *values, size_t count
+){
+    if (cache == NULL || values == NULL || !cache->is_initialized || !nhal_regcache_range_ok(cache, reg, count)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(cache->mutex, portMAX_DELAY);
+    nhal_result_t result = nhal_regcache_read_locked(cache, reg - cache->first_reg, values, count);
+    xSemaphoreGive(cache->mutex);
+    return result;
+}
+
+nhal_result_t nhal_esp32_i2c_regcache_write(
+    struct nhal_i2c_regcache *cache,
+    uint8_t reg, const uint8_t *values, size_t count
+){
+    if (cache == NULL || values == NULL || !cache->is_initialized || !nhal_regcache_range_ok(cache, reg, count)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(cache->mutex, portMAX_DELAY);
+    nhal_result_t result = nhal_regcache_write_locked(cache, reg - cache->first_reg, values, count);
+    xSemaphoreGive(cache->mutex);
+    return result;
+}
+
+nhal_result_t nhal_esp32_i2c_regcache_update_bits(
+    struct nhal_i2c_regcache *cache,
+    uint8_t reg, uint8_t mask, uint8_t value
+){
+    if (cache == NULL || !cache->is_initialized || !nhal_regcache_range_ok(cache, reg, 1)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    size_t index = reg - cache->first_reg;
+    uint8_t current;
+
+    xSemaphoreTake(cache->mutex, portMAX_DELAY);
+    nhal_result_t result = nhal_regcache_read_locked(cache, index, &current, 1);
+    if (result == NHAL_OK) {
+        uint8_t updated = (current & ~mask) | (value & mask);
+        if (updated != current || !nhal_bit_get(cache->cacheable, index)) {
+            result = nhal_regcache_write_locked(cache, index, &updated, 1);
+        }
+    }
+    xSemaphoreGive(cache->mutex);
+    return result;
+}
+
+nhal_result_t nhal_esp32_i2c_regcache_flush(struct nhal_i2c_regcache *cache){
+    if (cache == NULL || !cache->is_initialized) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_result_t result = NHAL_OK;
+    size_t i = 0;
+
+    xSemaphoreTake(cache->mutex, portMAX_DELAY);
+    while (i < cache->num_regs) {
+        if (!nhal_bit_get(cache->dirty, i)) {
+            i++;
+            continue;
+        }
+
+        // Grow the burst over following dirty registers and over short gaps
+        // of clean cached registers, whose shadow values are safe to rewrite.
+        size_t start = i;
+        size_t end = i + 1;
+        while (end < cache->num_regs) {
+            size_t next = end;
+            while (next < cache->num_regs && !nhal_bit_get(cache->dirty, next) &&
+                   nhal_bit_get(cache->cacheable, next) && nhal_bit_get(cache->valid, next) &&
+                   (next - end) < NHAL_ESP32_I2C_REGCACHE_MAX_GAP) {
+                next++;
+            }
+            if (next >= cache->num_regs || !nhal_bit_get(cache->dirty, next) ||
+                (next + 1 - start) > NHAL_ESP32_I2C_REGCACHE_MAX_BURST) {
+                break;
+            }
+            end = next + 1;
+        }
+
+        result = nhal_regcache_bus_write(cache, start, &cache->shadow[start], end - start);
+        if (result != NHAL_OK) {
+            break;
+        }
+
+        for (size_t j = start; j < end; ++j) {
+            if (nhal_bit_get(cache->dirty, j)) {
+                nhal_regcache_count(cache, &cache->stats.flushed_regs);
+                nhal_bit_set(cache->dirty, j, false);
+            }
+            if (!nhal_bit_get(cache->cacheable, j)) {
+                nhal_bit_set(cache->valid, j, false);
+            }
+        }
+        i = end;
+    }
+    xSemaphoreGive(cache->mutex);
+    return result;
+}
+
+nhal_result_t nhal_esp32_i2c_regcache_invalidate(struct nhal_i2c_regcache *cache){
+    if (cache == NULL || !cache->is_initialized) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(cache->mutex, portMAX_DELAY);
+    for (size_t i = 0; i < NHAL_ESP32_I2C_REGCACHE_BITMAP_SIZE; ++i) {
+        cache->valid[i] &= cache->dirty[i];
+    }
+    xSemaphoreGive(cache->mutex);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_regcache_get_stats(struct nhal_i2c_regcache *cache, struct nhal_i2c_regcache_stats *stats){
+    if (cache == NULL || stats == NULL || !cache->is_initialized) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&cache->stats_lock, stats, &cache->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_regcache_reset_stats(struct nhal_i2c_regcache *cache){
+    if (cache == NULL || !cache->is_initialized) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&cache->stats_lock, &cache->stats, sizeof(cache->stats));
+    return NHAL_OK;
+}
@@ -0,0 +1,247 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_i2c_target.h"
+#include "nhal_esp32_helpers.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_i2c_types.h"
+
+#include <string.h>
+
+static bool nhal_target_range_ok(const struct nhal_i2c_target *target, uint8_t reg, size_t count){
+    return count > 0 && (size_t)reg + count <= target->config.num_regs;
+}
+
+nhal_result_t nhal_esp32_i2c_target_update(
+    struct nhal_i2c_target *target,
+    uint8_t reg, const uint8_t *values, size_t count
+){
+    if (target == NULL || values == NULL || !target->is_running || !nhal_target_range_ok(target, reg, count)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&target->lock);
+    memcpy(&target->config.regs[reg], values, count);
+    portEXIT_CRITICAL(&target->lock);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_target_fetch(
+    struct nhal_i2c_target *target,
+    uint8_t reg, uint8_t *values, size_t count
+){
+    if (target == NULL || values == NULL || !target->is_running || !nhal_target_range_ok(target, reg, count)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&target->lock);
+    memcpy(values, &target->config.regs[reg], count);
+    portEXIT_CRITICAL(&target->lock);
+    return NHAL_OK;
+}
+
+bool nhal_esp32_i2c_target_take_dirty(struct nhal_i2c_target *target, uint8_t *dirty){
+    if (target == NULL || dirty == NULL) {
+        return false;
+    }
+
+    bool any = false;
+    portENTER_CRITICAL(&target->lock);
+    memcpy(dirty, target->dirty, sizeof(target->dirty));
+    memset(target->dirty, 0, sizeof(target->dirty));
+    portEXIT_CRITICAL(&target->lock);
+
+    for (size_t i = 0; i < sizeof(target->dirty); i++) {
+        any |= (dirty[i] != 0);
+    }
+    return any;
+}
+
+nhal_result_t nhal_esp32_i2c_target_get_stats(struct nhal_i2c_target *target, struct nhal_i2c_target_stats *stats){
+    if (target == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&target->lock, stats, &target->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_target_reset_stats(struct nhal_i2c_target *target){
+    if (target == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&target->lock, &target->stats, sizeof(target->stats));
+    return NHAL_OK;
+}
+
+#if NHAL_ESP32_I2C_TARGET_SUPPORTED
+
+static inline bool nhal_target_is_writable(const struct nhal_i2c_target *target, size_t reg){
+    const uint8_t *writable = target->config.writable;
+    return writable == NULL || ((writable[reg / 8] >> (reg % 8)) & 1u);
+}
+
+// Both callbacks run in the slave driver's ISR, and nothing ever queues
+// through i2c_slave_write(), so the TX FIFO belongs to them alone
+
+static bool IRAM_ATTR nhal_target_on_receive(i2c_slave_dev_handle_t handle, const i2c_slave_rx_done_event_data_t *evt, void *arg){
+    struct nhal_i2c_target *target = (struct nhal_i2c_target *)arg;
+    if (evt->length == 0) {
+        return false;
+    }
+
+    uint8_t first_reg = evt->buffer[0];
+    size_t stored = 0;
+    size_t lo = 0;
+    size_t hi = 0;
+    i2c_dev_t *hw = I2C_LL_GET_HW(target->config.i2c_bus_id);
+
+    portENTER_CRITICAL_ISR(&target->lock);
+
+    // Bytes still queued for the previous read belong to the old pointer;
+    // drop them so the next read starts at first_reg
+    uint32_t fifo_free = 0;
+    i2c_ll_get_txfifo_len(hw, &fifo_free);
+    target->stats.bytes_discarded += SOC_I2C_FIFO_LEN - fifo_free;
+    i2c_ll_txfifo_rst(hw);
+    target->read_ptr = first_reg;
+
+    for (uint32_t i = 1; i < evt->length; i++) {
+        size_t reg = (size_t)first_reg + (i - 1);
+        if (reg >= target->config.num_regs || !nhal_target_is_writable(target, reg)) {
+            target->stats.bytes_rejected++;
+            continue;
+        }
+        target->config.regs[reg] = evt->buffer[i];
+        target->dirty[reg / 8] |= (uint8_t)(1u << (reg % 8));
+        if (stored == 0) {
+            lo = reg;
+        }
+        hi = reg;
+        stored++;
+    }
+    if (stored > 0) {
+        target->stats.write_bursts++;
+        target->stats.bytes_written += stored;
+    }
+    portEXIT_CRITICAL_ISR(&target->lock);
+
+    if (stored > 0 && target->config.on_write != NULL) {
+        return target->config.on_write(target, (uint8_t)lo, hi - lo + 1, target->config.user_data);
+    }
+    return false;
+}
+
+static bool IRAM_ATTR nhal_target_on_request(i2c_slave_dev_handle_t handle, const i2c_slave_request_event_data_t *evt, void *arg){
+    struct nhal_i2c_target *target = (struct nhal_i2c_target *)arg;
+    uint8_t tx[SOC_I2C_FIFO_LEN];
+    i2c_dev_t *hw = I2C_LL_GET_HW(target->config.i2c_bus_id);
+
+    // The controller only asks once the FIFO is empty, so everything queued
+    // before has been clocked out and read_ptr is where the host is
+    portENTER_CRITICAL_ISR(&target->lock);
+    uint32_t fifo_free = 0;
+    i2c_ll_get_txfifo_len(hw, &fifo_free);
+    size_t count = target->config.tx_chunk;
+    if (count > fifo_free) {
+        count = fifo_free;
+    }
+
+    // Registers past the end of the window wrap to the start, like the pointer
+    uint32_t reg = target->read_ptr;
+    for (size_t i = 0; i < count; i++) {
+        tx[i] = target->config.regs[(reg + i) % target->config.num_regs];
+    }
+    i2c_ll_write_txfifo(hw, tx, (uint8_t)count);
+
+    target->read_ptr = (uint8_t)((reg + count) % target->config.num_regs);
+    target->stats.read_requests++;
+    target->stats.bytes_sent += count;
+    portEXIT_CRITICAL_ISR(&target->lock);
+    return false;
+}
+
+nhal_result_t nhal_esp32_i2c_target_start(struct nhal_i2c_target *target, const struct nhal_i2c_target_config *config){
+    if (target == NULL || config == NULL || config->regs == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    // Reads are queued straight into the hardware FIFO, which is also what
+    // lets a pointer write discard them
+    if (config->num_regs == 0 || config->num_regs > NHAL_ESP32_I2C_TARGET_MAX_REGS ||
+        config->tx_chunk > SOC_I2C_FIFO_LEN) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (target->is_running) {
+        return NHAL_ERR_BUSY;
+    }
+
+    memset(target, 0, sizeof(*target));
+    target->config = *config;
+    if (target->config.tx_chunk == 0) {
+        target->config.tx_chunk = NHAL_ESP32_I2C_TARGET_TX_CHUNK;
+    }
+    portMUX_INITIALIZE(&target->lock);
+
+    bool is_10bit = (config->address.type == NHAL_I2C_10BIT_ADDR);
+    i2c_slave_config_t slave_config = {
+        .i2c_port = config->i2c_bus_id,
+        .sda_io_num = config->sda_io_num,
+        .scl_io_num = config->scl_io_num,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .send_buf_depth = NHAL_ESP32_I2C_TARGET_BUF_DEPTH,
+        .receive_buf_depth = NHAL_ESP32_I2C_TARGET_BUF_DEPTH,
+        .slave_addr = is_10bit ? config->address.addr.address_10bit : config->address.addr.address_7bit,
+        .addr_bit_len = is_10bit ? I2C_ADDR_BIT_LEN_10 : I2C_ADDR_BIT_LEN_7,
+        .flags.enable_internal_pullup = config->enable_internal_pullup,
+    };
+
+    nhal_result_t result = nhal_map_esp_err(i2c_new_slave_device(&slave_config, &target->handle));
+    if (result == NHAL_OK) {
+        i2c_slave_event_callbacks_t callbacks = {
+            .on_request = nhal_target_on_request,
+            .on_receive = nhal_target_on_receive,
+        };
+        result = nhal_map_esp_err(i2c_slave_register_event_callbacks(target->handle, &callbacks, target));
+        if (result != NHAL_OK) {
+            i2c_del_slave_device(target->handle);
+            target->handle = NULL;
+        }
+    }
+
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    target->is_running = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_i2c_target_stop(struct nhal_i2c_target *target){
+    if (target == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!target->is_running) {
+        return NHAL_OK;
+    }
+
+    target->is_running = false;
+    i2c_del_slave_device(target->handle);
+    target->handle = NULL;
+    return NHAL_OK;
+}
+
+#else
+
+nhal_result_t nhal_esp32_i2c_target_start(struct nhal_i2c_target *target, const struct nhal_i2c_target_config *config){
+    return NHAL_ERR_UNSUPPORTED;
+}
+
+nhal_result_t nhal_esp32_i2c_target_stop(struct nhal_i2c_target *target){
+    return NHAL_ERR_UNSUPPORTED;
+}
+
+#endif
@@ -0,0 +1,332 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_sampler.h"
+#include "nhal_esp32_i2c_arbiter.h"
+#include "nhal_esp32_worker.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_i2c_types.h"
+#include "nhal_spi_types.h"
+#include "nhal_spi_master.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#include <stdint.h>
+#include <string.h>
+
+nhal_result_t nhal_esp32_sampler_ring_init(
+    struct nhal_sampler_ring *ring,
+    uint8_t *storage, size_t storage_size,
+    uint16_t sample_len
+) {
+    if (ring == NULL || storage == NULL || ((uintptr_t)storage & 7u) != 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    size_t stride = NHAL_ESP32_SAMPLER_RECORD_STRIDE(sample_len);
+    size_t records = storage_size / stride;
+    if (records == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    uint32_t capacity = 1;
+    while ((size_t)capacity * 2 <= records && capacity < (UINT32_MAX / 2)) {
+        capacity *= 2;
+    }
+
+    ring->storage = storage;
+    ring->capacity = capacity;
+    ring->stride = (uint32_t)stride;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+    return NHAL_OK;
+}
+
+size_t nhal_esp32_sampler_ring_peek(struct nhal_sampler_ring *ring, const uint8_t **span) {
+    if (ring == NULL || span == NULL) {
+        return 0;
+    }
+
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint32_t available = head - tail;
+    if (available == 0) {
+        *span = NULL;
+        return 0;
+    }
+
+    // Only hand out records up to the end of the storage; the rest follow on
+    // the next peek.
+    uint32_t index = tail & (ring->capacity - 1);
+    uint32_t contiguous = ring->capacity - index;
+    if (available > contiguous) {
+        available = contiguous;
+    }
+
+    *span = ring->storage + (size_t)index * ring->stride;
+    return available;
+}
+
+void nhal_esp32_sampler_ring_consume(struct nhal_sampler_ring *ring, size_t count) {
+    if (ring == NULL || count == 0) {
+        return;
+    }
+
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (count > head - tail) {
+        count = head - tail;
+    }
+
+    __atomic_store_n(&ring->tail, tail + (uint32_t)count, __ATOMIC_RELEASE);
+}
+
+static struct nhal_sampler_record *nhal_sampler_ring_reserve(struct nhal_sampler_ring *ring) {
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= ring->capacity) {
+        return NULL;
+    }
+
+    return (struct nhal_sampler_record *)(ring->storage + (size_t)(head & (ring->capacity - 1)) * ring->stride);
+}
+
+static void nhal_sampler_ring_publish(struct nhal_sampler_ring *ring) {
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+}
+
+static nhal_result_t nhal_sampler_read_stream(struct nhal_sampler *sampler, struct nhal_sampler_stream *stream, uint8_t *data) {
+    if (stream->bus == NHAL_SAMPLER_BUS_I2C) {
+        // A sample that cannot get the bus before its next slot is worthless
+        struct nhal_i2c_request_attr attr = {
+            .priority = NHAL_I2C_PRIORITY_HIGH,
+            .deadline_us = stream->next_due_us,
+        };
+        return nhal_esp32_i2c_write_read_reg_ex(
+            stream->i2c, stream->dev_address,
+            stream->command, stream->command_len,
+            data, stream->sample_len,
+            &attr
+        );
+    }
+
+    // Full duplex: the sample is clocked in after the command bytes
+    size_t frame_len = (size_t)stream->command_len + stream->sample_len;
+    memcpy(sampler->spi_tx, stream->command, stream->command_len);
+    memset(sampler->spi_tx + stream->command_len, 0, stream->sample_len);
+
+    nhal_result_t result = nhal_spi_master_write_read(
+        stream->spi, sampler->spi_tx, frame_len, sampler->spi_rx, frame_len
+    );
+    if (result == NHAL_OK) {
+        memcpy(data, sampler->spi_rx + stream->command_len, stream->sample_len);
+    }
+    return result;
+}
+
+static void nhal_sampler_take(struct nhal_sampler *sampler, struct nhal_sampler_stream *stream) {
+    uint64_t start_us = nhal_get_timestamp_microseconds();
+    uint64_t late_us = start_us - stream->next_due_us;
+
+    // Skip slots that have already passed instead of sampling in a burst
+    uint64_t skipped = late_us / stream->period_us;
+    stream->next_due_us += (skipped + 1) * stream->period_us;
+
+    nhal_result_t result = NHAL_OK;
+    struct nhal_sampler_record *record = nhal_sampler_ring_reserve(stream->ring);
+    if (record == NULL) {
+        stream->ring->dropped++;
+    } else {
+        result = nhal_sampler_read_stream(sampler, stream, record->data);
+        record->timestamp_us = start_us;
+        record->result = result;
+        record->length = (result == NHAL_OK) ? stream->sample_len : 0;
+        nhal_sampler_ring_publish(stream->ring);
+    }
+
+    uint32_t jitter_us = (late_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)late_us;
+
+    portENTER_CRITICAL(&sampler->lock);
+    stream->stats.samples++;
+    if (result != NHAL_OK) {
+        stream->stats.errors++;
+    }
+    stream->stats.overruns += (uint32_t)skipped;
+    stream->stats.total_jitter_us += jitter_us;
+    if (jitter_us > stream->stats.max_jitter_us) {
+        stream->stats.max_jitter_us = jitter_us;
+    }
+    portEXIT_CRITICAL(&sampler->lock);
+}
+
+static void nhal_sampler_timer_callback(void *arg) {
+    struct nhal_sampler *sampler = (struct nhal_sampler *)arg;
+    TaskHandle_t task = sampler->task;
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+}
+
+static void nhal_sampler_worker(void *arg) {
+    struct nhal_sampler *sampler = (struct nhal_sampler *)arg;
+
+    while (sampler->is_running) {
+        uint64_t now_us = nhal_get_timestamp_microseconds();
+        uint64_t next_due_us = UINT64_MAX;
+
+        for (size_t i = 0; i < sampler->num_streams; i++) {
+            struct nhal_sampler_stream *stream = &sampler->streams[i];
+            if (stream->next_due_us <= now_us) {
+                nhal_sampler_take(sampler, stream);
+                now_us = nhal_get_timestamp_microseconds();
+            }
+            if (stream->next_due_us < next_due_us) {
+                next_due_us = stream->next_due_us;
+            }
+        }
+
+        // Sleep until the earliest slot; a tick-based delay would round every
+        // period up to the FreeRTOS tick.
+        now_us = nhal_get_timestamp_microseconds();
+        if (next_due_us > now_us) {
+            esp_timer_start_once(sampler->timer, next_due_us - now_us);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            esp_timer_stop(sampler->timer);
+        }
+    }
+
+    nhal_worker_exit(&sampler->gate);
+}
+
+static bool nhal_sampler_stream_is_valid(const struct nhal_sampler_stream *stream) {
+    if (stream->ring == NULL || stream->period_us == 0 || stream->sample_len == 0) {
+        return false;
+    }
+
+    if (stream->command_len > NHAL_ESP32_SAMPLER_MAX_CMD_LEN) {
+        return false;
+    }
+
+    if (stream->ring->stride < NHAL_ESP32_SAMPLER_RECORD_STRIDE(stream->sample_len)) {
+        return false;
+    }
+
+    switch (stream->bus) {
+        case NHAL_SAMPLER_BUS_I2C:
+            return stream->i2c != NULL;
+        case NHAL_SAMPLER_BUS_SPI:
+            return stream->spi != NULL &&
+                   (size_t)stream->command_len + stream->sample_len <= NHAL_ESP32_SAMPLER_MAX_SPI_LEN;
+        default:
+            return false;
+    }
+}
+
+nhal_result_t nhal_esp32_sampler_start(
+    struct nhal_sampler *sampler,
+    struct nhal_sampler_stream *streams,
+    size_t num_streams
+) {
+    if (sampler == NULL || streams == NULL || num_streams == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (sampler->is_running) {
+        return NHAL_ERR_BUSY;
+    }
+
+    for (size_t i = 0; i < num_streams; i++) {
+        if (!nhal_sampler_stream_is_valid(&streams[i])) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+    }
+
+    sampler->streams = streams;
+    sampler->num_streams = num_streams;
+    sampler->task = NULL;
+    portMUX_INITIALIZE(&sampler->lock);
+    nhal_worker_gate_init(&sampler->gate);
+
+    esp_timer_create_args_t timer_args = {
+        .callback = nhal_sampler_timer_callback,
+        .arg = sampler,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "nhal_sampler",
+    };
+    if (esp_timer_create(&timer_args, &sampler->timer) != ESP_OK) {
+        return NHAL_ERR_OTHER;
+    }
+
+    // Every stream is phase-aligned to the same epoch
+    sampler->epoch_us = nhal_get_timestamp_microseconds();
+    for (size_t i = 0; i < num_streams; i++) {
+        streams[i].next_due_us = sampler->epoch_us + streams[i].phase_us;
+        memset(&streams[i].stats, 0, sizeof(streams[i].stats));
+    }
+
+    sampler->is_running = true;
+    sampler->task = xTaskCreateStatic(
+        nhal_sampler_worker,
+        "nhal_sampler",
+        NHAL_ESP32_SAMPLER_TASK_STACK_SIZE,
+        sampler,
+        NHAL_ESP32_SAMPLER_TASK_PRIORITY,
+        sampler->task_stack,
+        &sampler->task_struct
+    );
+    if (sampler->task == NULL) {
+        sampler->is_running = false;
+        esp_timer_delete(sampler->timer);
+        sampler->timer = NULL;
+        return NHAL_ERR_OTHER;
+    }
+
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_sampler_stop(struct nhal_sampler *sampler) {
+    if (sampler == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!sampler->is_running) {
+        return NHAL_OK;
+    }
+
+    // The worker finishes the sample in progress, sees the flag and exits
+    sampler->is_running = false;
+    xTaskNotifyGive(sampler->task);
+    nhal_worker_wait_stopped(&sampler->gate, sampler->task);
+    sampler->task = NULL;
+
+    esp_timer_stop(sampler->timer);
+    esp_timer_delete(sampler->timer);
+    sampler->timer = NULL;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_sampler_get_stream_stats(
+    struct nhal_sampler *sampler,
+    size_t stream_index,
+    struct nhal_sampler_stream_stats *stats
+) {
+    if (sampler == NULL || stats == NULL || sampler->streams == NULL || stream_index >= sampler->num_streams) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&sampler->lock, stats, &sampler->streams[stream_index].stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_sampler_reset_stream_stats(struct nhal_sampler *sampler, size_t stream_index) {
+    if (sampler == NULL || sampler->streams == NULL || stream_index >= sampler->num_streams) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_sampler_stream_stats *stats = &sampler->streams[stream_index].stats;
+    nhal_stats_clear(&sampler->lock, stats, sizeof(*stats));
+    return NHAL_OK;
+}
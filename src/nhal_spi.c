@@ -1,13 +1,58 @@
 #include "esp_log.h"
 #include "nhal_esp32_defs.h"
 #include "nhal_esp32_helpers.h"
+#include "nhal_esp32_spi.h"
+#include "nhal_esp32_spi_bus.h"
+#include "nhal_esp32_spi_internal.h"
+#include "nhal_esp32_stats.h"
 
 #include "nhal_common.h"
 #include "nhal_spi_types.h"
 #include "nhal_spi_master.h"
 
 #include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_memory_utils.h"
+#include "driver/gpio.h"
 #include "driver/spi_master.h"
+#include "soc/spi_pins.h"
+
+#include <string.h>
+
+static void IRAM_ATTR nhal_spi_pre_cb(spi_transaction_t *trans) {
+    struct nhal_spi_trans_hook *hook = (struct nhal_spi_trans_hook *)trans->user;
+    if (hook == NULL) {
+        return;
+    }
+
+    hook->start_us = esp_timer_get_time();
+
+    // Transactions on one host are serialized by the driver
+    struct nhal_spi_bus *bus = hook->ctx->bus;
+    if (bus != NULL && bus->last_device != hook->ctx) {
+        bus->last_device = hook->ctx;
+        portENTER_CRITICAL_ISR(&bus->lock);
+        bus->stats.device_switches++;
+        portEXIT_CRITICAL_ISR(&bus->lock);
+    }
+
+    if (hook->pre != NULL) {
+        hook->pre(trans);
+    }
+}
+
+static void IRAM_ATTR nhal_spi_post_cb(spi_transaction_t *trans) {
+    struct nhal_spi_trans_hook *hook = (struct nhal_spi_trans_hook *)trans->user;
+    if (hook == NULL) {
+        return;
+    }
+
+    hook->end_us = esp_timer_get_time();
+    if (hook->post != NULL) {
+        hook->post(trans);
+    }
+}
 
 static void nhal_config_to_esp_config(struct nhal_spi_config *config, spi_device_interface_config_t *esp_config) {
     esp_config->command_bits = 0;
@@ -18,9 +63,11 @@ static void nhal_config_to_esp_config(struct nhal_spi_config *config, spi_device
     esp_config->cs_ena_pretrans = 0;
     esp_config->cs_ena_posttrans = 0;
     esp_config->flags = 0;
-    esp_config->queue_size = 1; // Basic mode uses minimal queue
-    esp_config->pre_cb = NULL;
-    esp_config->post_cb = NULL;
+    // Blocking calls need one slot; queued transactions (nhal_esp32_spi_queue.h) more
+    esp_config->queue_size = config->impl_config->queue_size > 0 ? config->impl_config->queue_size : 1;
+    esp_config->input_delay_ns = config->impl_config->input_delay_ns;
+    esp_config->pre_cb = nhal_spi_pre_cb;
+    esp_config->post_cb = nhal_spi_post_cb;
 
     // Set SPI mode (CPOL and CPHA)
     switch (config->mode) {
@@ -41,6 +88,11 @@ static void nhal_config_to_esp_config(struct nhal_spi_config *config, spi_device
             break;
     }
 
+    // The controller only drives dual/quad data phases in half-duplex mode
+    if (config->duplex == NHAL_SPI_HALF_DUPLEX) {
+        esp_config->flags |= SPI_DEVICE_HALFDUPLEX;
+    }
+
     // Set bit order
     if (config->bit_order == NHAL_SPI_BIT_ORDER_LSB_FIRST) {
         esp_config->flags |= SPI_DEVICE_BIT_LSBFIRST;
@@ -50,14 +102,253 @@ static void nhal_config_to_esp_config(struct nhal_spi_config *config, spi_device
     esp_config->spics_io_num = config->impl_config->cs_pin;
 }
 
-static void nhal_bus_config_to_esp_config(struct nhal_spi_config *config, spi_bus_config_t *esp_bus_config) {
-    esp_bus_config->mosi_io_num = config->impl_config->mosi_pin;
-    esp_bus_config->miso_io_num = config->impl_config->miso_pin;
-    esp_bus_config->sclk_io_num = config->impl_config->sclk_pin;
+void nhal_spi_bus_config_to_esp(const struct nhal_spi_bus_config *config, spi_bus_config_t *esp_bus_config) {
+    esp_bus_config->mosi_io_num = config->mosi_pin;
+    esp_bus_config->miso_io_num = config->miso_pin;
+    esp_bus_config->sclk_io_num = config->sclk_pin;
     esp_bus_config->quadwp_io_num = -1;
     esp_bus_config->quadhd_io_num = -1;
-    esp_bus_config->max_transfer_sz = 0; // Use default for basic mode (no DMA)
+    // Without DMA transfers are limited to the hardware FIFO; 0 keeps the IDF default
+    esp_bus_config->max_transfer_sz = config->use_dma ? config->max_transfer_sz : 0;
     esp_bus_config->flags = SPICOMMON_BUSFLAG_MASTER;
+
+    if (config->data_lines == 4) {
+        esp_bus_config->quadwp_io_num = config->quadwp_pin;
+        esp_bus_config->quadhd_io_num = config->quadhd_pin;
+        esp_bus_config->flags |= SPICOMMON_BUSFLAG_QUAD;
+    } else if (config->data_lines == 2) {
+        esp_bus_config->flags |= SPICOMMON_BUSFLAG_DUAL;
+    }
+}
+
+static void nhal_bus_config_to_esp_config(struct nhal_spi_config *config, spi_bus_config_t *esp_bus_config) {
+    const struct nhal_spi_impl_config *impl = config->impl_config;
+    struct nhal_spi_bus_config bus_config = {
+        .mosi_pin = impl->mosi_pin,
+        .miso_pin = impl->miso_pin,
+        .sclk_pin = impl->sclk_pin,
+        .data_lines = impl->data_lines,
+        .quadwp_pin = impl->quadwp_pin,
+        .quadhd_pin = impl->quadhd_pin,
+        .use_dma = impl->use_dma,
+        .max_transfer_sz = impl->max_transfer_sz,
+    };
+    nhal_spi_bus_config_to_esp(&bus_config, esp_bus_config);
+}
+
+// Unrouted pins (-1, or 0xFF from the uint8_t impl config) do not count
+static bool nhal_spi_pin_on_iomux(int pin, int iomux_pin) {
+    return pin < 0 || pin >= GPIO_NUM_MAX || pin == iomux_pin;
+}
+
+bool nhal_spi_pins_on_iomux(spi_host_device_t host, const spi_bus_config_t *bus_config) {
+    bool quad = (bus_config->flags & SPICOMMON_BUSFLAG_WPHD) != 0;
+    switch (host) {
+#ifdef SPI2_IOMUX_PIN_NUM_CLK
+        case SPI2_HOST:
+            return nhal_spi_pin_on_iomux(bus_config->sclk_io_num, SPI2_IOMUX_PIN_NUM_CLK) &&
+                   nhal_spi_pin_on_iomux(bus_config->mosi_io_num, SPI2_IOMUX_PIN_NUM_MOSI) &&
+                   nhal_spi_pin_on_iomux(bus_config->miso_io_num, SPI2_IOMUX_PIN_NUM_MISO) &&
+                   (!quad || (nhal_spi_pin_on_iomux(bus_config->quadwp_io_num, SPI2_IOMUX_PIN_NUM_WP) &&
+                              nhal_spi_pin_on_iomux(bus_config->quadhd_io_num, SPI2_IOMUX_PIN_NUM_HD)));
+#endif
+#ifdef SPI3_IOMUX_PIN_NUM_CLK
+        case SPI3_HOST:
+            return nhal_spi_pin_on_iomux(bus_config->sclk_io_num, SPI3_IOMUX_PIN_NUM_CLK) &&
+                   nhal_spi_pin_on_iomux(bus_config->mosi_io_num, SPI3_IOMUX_PIN_NUM_MOSI) &&
+                   nhal_spi_pin_on_iomux(bus_config->miso_io_num, SPI3_IOMUX_PIN_NUM_MISO) &&
+                   (!quad || (nhal_spi_pin_on_iomux(bus_config->quadwp_io_num, SPI3_IOMUX_PIN_NUM_WP) &&
+                              nhal_spi_pin_on_iomux(bus_config->quadhd_io_num, SPI3_IOMUX_PIN_NUM_HD)));
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * Fastest SCLK for the routing. Half duplex makes up for a late MISO with
+ * dummy cycles; full duplex cannot, so there the sampling delay also limits
+ * the clock.
+ */
+static uint32_t nhal_spi_freq_limit(bool iomux_pins, bool half_duplex, uint8_t input_delay_ns) {
+    uint32_t limit = iomux_pins ? NHAL_ESP32_SPI_MAX_FREQ_IOMUX_HZ : NHAL_ESP32_SPI_MAX_FREQ_GPIO_HZ;
+    if (!half_duplex) {
+        int sampling_limit = spi_get_freq_limit(!iomux_pins, input_delay_ns);
+        if (sampling_limit > 0 && (uint32_t)sampling_limit < limit) {
+            limit = (uint32_t)sampling_limit;
+        }
+    }
+    return limit;
+}
+
+static size_t nhal_spi_size_class(size_t len) {
+    size_t size_class = 0;
+    size_t limit = 64;
+    while (size_class < NHAL_ESP32_SPI_STATS_SIZE_CLASSES - 1 && len > limit) {
+        limit <<= 1;
+        size_class++;
+    }
+    return size_class;
+}
+
+void nhal_spi_stats_record(
+    struct nhal_spi_context *ctx,
+    size_t len,
+    uint64_t elapsed_us,
+    const struct nhal_spi_trans_hook *hook,
+    nhal_result_t result
+) {
+    struct nhal_spi_size_class_stats *size_class = &ctx->stats.size_classes[nhal_spi_size_class(len)];
+
+    portENTER_CRITICAL(&ctx->stats_lock);
+    ctx->stats.transactions++;
+    if (result != NHAL_OK) {
+        ctx->stats.errors++;
+    }
+    ctx->stats.bytes += len;
+    ctx->stats.total_time_us += elapsed_us;
+    if (elapsed_us > ctx->stats.max_time_us) {
+        ctx->stats.max_time_us = (uint32_t)elapsed_us;
+    }
+    if (hook != NULL && hook->end_us > hook->start_us) {
+        ctx->stats.bus_time_us += hook->end_us - hook->start_us;
+    }
+
+    size_class->transactions++;
+    size_class->bytes += len;
+    size_class->time_us += elapsed_us;
+
+    if (hook != NULL) {
+        size_t mode = (hook->data_lines == 4) ? 2 : (hook->data_lines == 2) ? 1 : 0;
+        struct nhal_spi_line_mode_stats *line_mode = &ctx->stats.line_modes[mode];
+        line_mode->transactions++;
+        line_mode->bytes += len;
+        if (hook->end_us > hook->start_us) {
+            line_mode->bus_time_us += hook->end_us - hook->start_us;
+        }
+    }
+    portEXIT_CRITICAL(&ctx->stats_lock);
+}
+
+// DMA reads whole words: receive buffers also need a length multiple of 4.
+static bool nhal_spi_dma_ready(const void *buffer, size_t len, bool is_rx) {
+    if (!esp_ptr_dma_capable(buffer) || ((uintptr_t)buffer & 3u) != 0) {
+        return false;
+    }
+    return !is_rx || (len & 3u) == 0;
+}
+
+// The task holding the bus through nhal_esp32_spi_acquire() already owns the
+// mutex; its transfers run without taking it again.
+bool nhal_spi_is_bus_owner(struct nhal_spi_context *ctx) {
+    return ctx->bus_owner != NULL && ctx->bus_owner == xTaskGetCurrentTaskHandle();
+}
+
+BaseType_t nhal_spi_lock(struct nhal_spi_context *ctx) {
+    if (nhal_spi_is_bus_owner(ctx)) {
+        return pdTRUE;
+    }
+    return xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
+}
+
+static void nhal_spi_unlock(struct nhal_spi_context *ctx) {
+    if (!nhal_spi_is_bus_owner(ctx)) {
+        xSemaphoreGive(ctx->mutex);
+    }
+}
+
+/**
+ * Runs one transaction of len_bits data bits; must be called with the context
+ * mutex held. Command, address and dummy phases already set in ext are kept.
+ * Up to 4 bytes travel in the transaction descriptor itself; transfers up to
+ * the polling threshold busy-wait instead of sleeping on the completion
+ * interrupt. With DMA, buffers the engine cannot use directly are copied
+ * through the context bounce buffer instead of a per-transaction heap
+ * allocation in the driver.
+ */
+nhal_result_t nhal_spi_transmit_ext_locked(
+    struct nhal_spi_context *ctx,
+    spi_transaction_ext_t *ext,
+    const uint8_t *tx_data, uint8_t *rx_data,
+    size_t len_bits
+) {
+    struct nhal_spi_trans_hook hook = { .ctx = ctx };
+    spi_transaction_t *trans = &ext->base;
+    size_t len = (len_bits + 7) / 8;
+    hook.data_lines = (trans->flags & SPI_TRANS_MODE_QIO) ? 4 : (trans->flags & SPI_TRANS_MODE_DIO) ? 2 : 1;
+    trans->length = len_bits;
+    trans->tx_buffer = tx_data;
+    trans->rx_buffer = rx_data;
+    trans->user = &hook;
+
+    bool inline_data = (len <= 4);
+    if (inline_data) {
+        if (tx_data != NULL) {
+            trans->flags |= SPI_TRANS_USE_TXDATA;
+            memcpy(trans->tx_data, tx_data, len);
+        }
+        if (rx_data != NULL) {
+            trans->flags |= SPI_TRANS_USE_RXDATA;
+        }
+    }
+
+    uint8_t *rx_bounce = NULL;
+    if (ctx->use_dma && !inline_data) {
+        bool bounce_tx = tx_data != NULL && !nhal_spi_dma_ready(tx_data, len, false);
+        bool bounce_rx = rx_data != NULL && !nhal_spi_dma_ready(rx_data, len, true);
+        size_t slot = (len + 3u) & ~(size_t)3u;
+        size_t needed = (bounce_tx ? slot : 0) + (bounce_rx ? slot : 0);
+
+        if (needed > 0 && ctx->bounce_buffer != NULL && needed <= ctx->bounce_buffer_size) {
+            uint8_t *next = ctx->bounce_buffer;
+            if (bounce_tx) {
+                memcpy(next, tx_data, len);
+                trans->tx_buffer = next;
+                next += slot;
+            }
+            if (bounce_rx) {
+                rx_bounce = next;
+                trans->rx_buffer = rx_bounce;
+            }
+            portENTER_CRITICAL(&ctx->stats_lock);
+            ctx->stats.bounced++;
+            ctx->stats.bounced_bytes += len;
+            portEXIT_CRITICAL(&ctx->stats_lock);
+        } else if (needed > 0) {
+            portENTER_CRITICAL(&ctx->stats_lock);
+            ctx->stats.driver_bounced++;
+            portEXIT_CRITICAL(&ctx->stats_lock);
+        }
+    }
+
+    bool use_polling = (len <= ctx->polling_threshold);
+    uint64_t start_us = nhal_get_timestamp_microseconds();
+    nhal_result_t spi_result = nhal_map_esp_err(
+        use_polling ? spi_device_polling_transmit(ctx->device_handle, trans)
+                    : spi_device_transmit(ctx->device_handle, trans)
+    );
+    uint64_t elapsed_us = nhal_get_timestamp_microseconds() - start_us;
+    nhal_spi_stats_record(ctx, len, elapsed_us, &hook, spi_result);
+    if (use_polling) {
+        portENTER_CRITICAL(&ctx->stats_lock);
+        ctx->stats.polled++;
+        ctx->stats.polled_time_us += elapsed_us;
+        portEXIT_CRITICAL(&ctx->stats_lock);
+    }
+
+    if (spi_result == NHAL_OK && rx_data != NULL) {
+        if (inline_data) {
+            memcpy(rx_data, trans->rx_data, len);
+        } else if (rx_bounce != NULL) {
+            memcpy(rx_data, rx_bounce, len);
+        }
+    }
+    return spi_result;
+}
+
+static nhal_result_t nhal_spi_transmit_locked(struct nhal_spi_context *ctx, const uint8_t *tx_data, uint8_t *rx_data, size_t len) {
+    spi_transaction_ext_t ext = {0};
+    return nhal_spi_transmit_ext_locked(ctx, &ext, tx_data, rx_data, len * 8);
 }
 
 nhal_result_t nhal_spi_master_init(struct nhal_spi_context *ctx) {
@@ -77,7 +368,16 @@ nhal_result_t nhal_spi_master_init(struct nhal_spi_context *ctx) {
 
     ctx->is_initialized = true;
     ctx->is_configured = false;
+    ctx->use_dma = false;
+    ctx->polling_threshold = 0;
     ctx->device_handle = NULL;
+    ctx->bus = NULL;
+    ctx->bus_owner = NULL;
+    ctx->bus_owner_depth = 0;
+    ctx->bounce_buffer = NULL;
+    ctx->bounce_buffer_size = 0;
+    portMUX_INITIALIZE(&ctx->stats_lock);
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
 
     return NHAL_OK;
 }
@@ -103,11 +403,27 @@ nhal_result_t nhal_spi_master_deinit(struct nhal_spi_context *ctx) {
             ctx->device_handle = NULL;
         }
 
-        // Free SPI bus
-        esp_err_t ret_err = spi_bus_free(ctx->spi_bus_id);
-        if (ret_err != ESP_OK) {
-            xSemaphoreGive(ctx->mutex);
-            return nhal_map_esp_err(ret_err);
+        if (ctx->bus != NULL) {
+            // The shared bus stays up for the other devices
+            if (ctx->is_configured) {
+                portENTER_CRITICAL(&ctx->bus->lock);
+                ctx->bus->num_devices--;
+                portEXIT_CRITICAL(&ctx->bus->lock);
+            }
+            ctx->is_configured = false;
+        } else {
+            // Free SPI bus
+            esp_err_t ret_err = spi_bus_free(ctx->spi_bus_id);
+            if (ret_err != ESP_OK) {
+                xSemaphoreGive(ctx->mutex);
+                return nhal_map_esp_err(ret_err);
+            }
+        }
+
+        if (ctx->bounce_buffer != NULL) {
+            heap_caps_free(ctx->bounce_buffer);
+            ctx->bounce_buffer = NULL;
+            ctx->bounce_buffer_size = 0;
         }
 
         // Clean up mutex and reset state
@@ -129,6 +445,11 @@ nhal_result_t nhal_spi_master_set_config(struct nhal_spi_context *ctx, struct nh
         return NHAL_ERR_INVALID_ARG;
     }
 
+    uint8_t data_lines = config->impl_config->data_lines;
+    if (data_lines > 1 && data_lines != 2 && data_lines != 4) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
     esp_err_t ret_err;
     nhal_result_t spi_result = NHAL_OK;
     spi_bus_config_t esp_bus_config = {0};
@@ -142,11 +463,53 @@ nhal_result_t nhal_spi_master_set_config(struct nhal_spi_context *ctx, struct nh
 
     BaseType_t mutex_ret_err = xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
     if (mutex_ret_err == pdTRUE) {
-        // Initialize SPI bus
-        ret_err = spi_bus_initialize(ctx->spi_bus_id, &esp_bus_config, SPI_DMA_DISABLED);
-        if (ret_err != ESP_OK) {
-            spi_result = nhal_map_esp_err(ret_err);
-            goto free_mutex_and_ret;
+        if (ctx->bus != NULL) {
+            // Shared bus: pins and DMA come from the bus, only the device is (re)added
+            if (!ctx->bus->is_initialized) {
+                spi_result = NHAL_ERR_NOT_INITIALIZED;
+                goto free_mutex_and_ret;
+            }
+            if (ctx->is_configured) {
+                ret_err = spi_bus_remove_device(ctx->device_handle);
+                if (ret_err != ESP_OK) {
+                    spi_result = nhal_map_esp_err(ret_err);
+                    goto free_mutex_and_ret;
+                }
+                ctx->device_handle = NULL;
+                ctx->is_configured = false;
+                portENTER_CRITICAL(&ctx->bus->lock);
+                ctx->bus->num_devices--;
+                portEXIT_CRITICAL(&ctx->bus->lock);
+            }
+            ctx->spi_bus_id = ctx->bus->spi_bus_id;
+            ctx->use_dma = ctx->bus->use_dma;
+            ctx->data_lines = ctx->bus->data_lines;
+            ctx->iomux_pins = ctx->bus->iomux_pins;
+        } else {
+            // Initialize SPI bus
+            spi_dma_chan_t dma_chan = config->impl_config->use_dma ? SPI_DMA_CH_AUTO : SPI_DMA_DISABLED;
+            ret_err = spi_bus_initialize(ctx->spi_bus_id, &esp_bus_config, dma_chan);
+            if (ret_err != ESP_OK) {
+                spi_result = nhal_map_esp_err(ret_err);
+                goto free_mutex_and_ret;
+            }
+            ctx->use_dma = config->impl_config->use_dma;
+            ctx->data_lines = (data_lines > 1) ? data_lines : 1;
+            ctx->iomux_pins = nhal_spi_pins_on_iomux(ctx->spi_bus_id, &esp_bus_config);
+        }
+
+        ctx->max_frequency_hz = nhal_spi_freq_limit(
+            ctx->iomux_pins, config->duplex == NHAL_SPI_HALF_DUPLEX, config->impl_config->input_delay_ns
+        );
+        if (config->impl_config->max_frequency) {
+            esp_device_config.clock_speed_hz = ctx->max_frequency_hz;
+        }
+
+        // A failed allocation only means the driver bounces on its own
+        if (ctx->use_dma && config->impl_config->bounce_buffer_size > 0 && ctx->bounce_buffer == NULL) {
+            size_t bounce_size = (config->impl_config->bounce_buffer_size + 3u) & ~(size_t)3u;
+            ctx->bounce_buffer = heap_caps_aligned_alloc(4, bounce_size, MALLOC_CAP_DMA);
+            ctx->bounce_buffer_size = (ctx->bounce_buffer != NULL) ? bounce_size : 0;
         }
 
         // Add device to SPI bus
@@ -156,8 +519,22 @@ nhal_result_t nhal_spi_master_set_config(struct nhal_spi_context *ctx, struct nh
             goto free_mutex_and_ret;
         }
 
+        // The divider only reaches some clocks; keep the one really used
+        int actual_khz = 0;
+        ret_err = spi_device_get_actual_freq(ctx->device_handle, &actual_khz);
+        ctx->actual_frequency_hz = (ret_err == ESP_OK) ? (uint32_t)actual_khz * 1000u : 0;
+
+        ctx->queue_size = esp_device_config.queue_size;
+        ctx->polling_threshold = config->impl_config->polling_threshold;
+        ctx->half_duplex = (config->duplex == NHAL_SPI_HALF_DUPLEX);
         ctx->is_configured = true;
 
+        if (ctx->bus != NULL) {
+            portENTER_CRITICAL(&ctx->bus->lock);
+            ctx->bus->num_devices++;
+            portEXIT_CRITICAL(&ctx->bus->lock);
+        }
+
         free_mutex_and_ret:
             xSemaphoreGive(ctx->mutex);
             return spi_result;
@@ -183,18 +560,11 @@ nhal_result_t nhal_spi_master_write(struct nhal_spi_context *ctx, const uint8_t
         return NHAL_ERR_NOT_CONFIGURED;
     }
 
-    BaseType_t mutex_ret_err = xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
+    BaseType_t mutex_ret_err = nhal_spi_lock(ctx);
     if (mutex_ret_err == pdTRUE) {
-        spi_transaction_t trans = {0};
-        trans.length = len * 8; // Length in bits
-        trans.tx_buffer = data;
-        trans.rx_buffer = NULL;
-
-        nhal_result_t spi_result = nhal_map_esp_err(
-            spi_device_transmit(ctx->device_handle, &trans)
-        );
+        nhal_result_t spi_result = nhal_spi_transmit_locked(ctx, data, NULL, len);
 
-        xSemaphoreGive(ctx->mutex);
+        nhal_spi_unlock(ctx);
         return spi_result;
     } else {
         return NHAL_ERR_BUSY;
@@ -214,18 +584,11 @@ nhal_result_t nhal_spi_master_read(struct nhal_spi_context *ctx, uint8_t *data,
         return NHAL_ERR_NOT_CONFIGURED;
     }
 
-    BaseType_t mutex_ret_err = xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
+    BaseType_t mutex_ret_err = nhal_spi_lock(ctx);
     if (mutex_ret_err == pdTRUE) {
-        spi_transaction_t trans = {0};
-        trans.length = len * 8; // Length in bits
-        trans.tx_buffer = NULL;
-        trans.rx_buffer = data;
+        nhal_result_t spi_result = nhal_spi_transmit_locked(ctx, NULL, data, len);
 
-        nhal_result_t spi_result = nhal_map_esp_err(
-            spi_device_transmit(ctx->device_handle, &trans)
-        );
-
-        xSemaphoreGive(ctx->mutex);
+        nhal_spi_unlock(ctx);
         return spi_result;
     } else {
         return NHAL_ERR_BUSY;
@@ -249,23 +612,111 @@ nhal_result_t nhal_spi_master_write_read(struct nhal_spi_context *ctx, const uin
         return NHAL_ERR_NOT_CONFIGURED;
     }
 
-    BaseType_t mutex_ret_err = xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
+    BaseType_t mutex_ret_err = nhal_spi_lock(ctx);
     if (mutex_ret_err == pdTRUE) {
-        spi_transaction_t trans = {0};
-
         // For simultaneous write/read, lengths must match in ESP-IDF
         size_t transfer_len = (tx_len > rx_len) ? tx_len : rx_len;
-        trans.length = transfer_len * 8; // Length in bits
-        trans.tx_buffer = tx_data;
-        trans.rx_buffer = rx_data;
-
-        nhal_result_t spi_result = nhal_map_esp_err(
-            spi_device_transmit(ctx->device_handle, &trans)
-        );
+        nhal_result_t spi_result = nhal_spi_transmit_locked(ctx, tx_data, rx_data, transfer_len);
 
-        xSemaphoreGive(ctx->mutex);
+        nhal_spi_unlock(ctx);
         return spi_result;
     } else {
         return NHAL_ERR_BUSY;
     }
 }
+
+nhal_result_t nhal_esp32_spi_get_stats(struct nhal_spi_context *ctx, struct nhal_spi_stats *stats) {
+    if (ctx == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_copy(&ctx->stats_lock, stats, &ctx->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_reset_stats(struct nhal_spi_context *ctx) {
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_clear(&ctx->stats_lock, &ctx->stats, sizeof(ctx->stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_acquire(struct nhal_spi_context *ctx) {
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    if (nhal_spi_is_bus_owner(ctx)) {
+        ctx->bus_owner_depth++;
+        return NHAL_OK;
+    }
+
+    BaseType_t mutex_ret_err = xSemaphoreTake(ctx->mutex, pdMS_TO_TICKS(ctx->timeout_ms));
+    if (mutex_ret_err == pdTRUE) {
+        // The driver only accepts an unbounded wait; the mutex above already
+        // bounded ours
+        esp_err_t ret_err = spi_device_acquire_bus(ctx->device_handle, portMAX_DELAY);
+        if (ret_err != ESP_OK) {
+            xSemaphoreGive(ctx->mutex);
+            return nhal_map_esp_err(ret_err);
+        }
+
+        ctx->bus_owner = xTaskGetCurrentTaskHandle();
+        ctx->bus_owner_depth = 1;
+        return NHAL_OK;
+    } else {
+        return NHAL_ERR_BUSY;
+    }
+}
+
+nhal_result_t nhal_esp32_spi_release(struct nhal_spi_context *ctx) {
+    if (ctx == NULL || !nhal_spi_is_bus_owner(ctx)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (--ctx->bus_owner_depth > 0) {
+        return NHAL_OK;
+    }
+
+    spi_device_release_bus(ctx->device_handle);
+    ctx->bus_owner = NULL;
+    xSemaphoreGive(ctx->mutex);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_set_polling_threshold(struct nhal_spi_context *ctx, uint16_t threshold) {
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    BaseType_t mutex_ret_err = nhal_spi_lock(ctx);
+    if (mutex_ret_err == pdTRUE) {
+        ctx->polling_threshold = threshold;
+        nhal_spi_unlock(ctx);
+        return NHAL_OK;
+    } else {
+        return NHAL_ERR_BUSY;
+    }
+}
@@ -0,0 +1,120 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_helpers.h"
+#include "nhal_esp32_spi_bus.h"
+#include "nhal_esp32_spi_internal.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_spi_types.h"
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "driver/spi_master.h"
+
+#include <string.h>
+
+nhal_result_t nhal_esp32_spi_bus_init(
+    struct nhal_spi_bus *bus,
+    spi_host_device_t spi_bus_id,
+    const struct nhal_spi_bus_config *config
+) {
+    if (bus == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (config->data_lines > 1 && config->data_lines != 2 && config->data_lines != 4) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (bus->is_initialized) {
+        return NHAL_OK;
+    }
+
+    spi_bus_config_t esp_bus_config = {0};
+    nhal_spi_bus_config_to_esp(config, &esp_bus_config);
+
+    spi_dma_chan_t dma_chan = config->use_dma ? SPI_DMA_CH_AUTO : SPI_DMA_DISABLED;
+    esp_err_t ret_err = spi_bus_initialize(spi_bus_id, &esp_bus_config, dma_chan);
+    if (ret_err != ESP_OK) {
+        return nhal_map_esp_err(ret_err);
+    }
+
+    memset(bus, 0, sizeof(*bus));
+    portMUX_INITIALIZE(&bus->lock);
+    bus->spi_bus_id = spi_bus_id;
+    bus->use_dma = config->use_dma;
+    bus->data_lines = (config->data_lines > 1) ? config->data_lines : 1;
+    bus->iomux_pins = nhal_spi_pins_on_iomux(spi_bus_id, &esp_bus_config);
+    bus->is_initialized = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_bus_deinit(struct nhal_spi_bus *bus) {
+    if (bus == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!bus->is_initialized) {
+        return NHAL_OK;
+    }
+
+    portENTER_CRITICAL(&bus->lock);
+    uint32_t num_devices = bus->num_devices;
+    portEXIT_CRITICAL(&bus->lock);
+    if (num_devices > 0) {
+        return NHAL_ERR_BUSY;
+    }
+
+    esp_err_t ret_err = spi_bus_free(bus->spi_bus_id);
+    if (ret_err != ESP_OK) {
+        return nhal_map_esp_err(ret_err);
+    }
+
+    bus->is_initialized = false;
+    bus->last_device = NULL;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_bus_attach(struct nhal_spi_bus *bus, struct nhal_spi_context *ctx) {
+    if (bus == NULL || ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!bus->is_initialized || !ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (ctx->is_configured) {
+        return NHAL_ERR_BUSY;
+    }
+
+    ctx->bus = bus;
+    ctx->spi_bus_id = bus->spi_bus_id;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_bus_get_stats(struct nhal_spi_bus *bus, struct nhal_spi_bus_stats *stats) {
+    if (bus == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!bus->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_copy(&bus->lock, stats, &bus->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_bus_reset_stats(struct nhal_spi_bus *bus) {
+    if (bus == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!bus->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_clear(&bus->lock, &bus->stats, sizeof(bus->stats));
+    return NHAL_OK;
+}
@@ -0,0 +1,117 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_spi_dma.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+
+#include <string.h>
+
+nhal_result_t nhal_esp32_spi_dma_pool_init(struct nhal_spi_dma_pool *pool, size_t num_buffers, size_t buffer_size) {
+    if (pool == NULL || num_buffers == 0 || num_buffers > NHAL_ESP32_SPI_DMA_POOL_MAX_BUFFERS || buffer_size == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+    portMUX_INITIALIZE(&pool->lock);
+    pool->buffer_size = (buffer_size + 3u) & ~(size_t)3u;
+
+    for (size_t i = 0; i < num_buffers; i++) {
+        pool->buffers[i] = heap_caps_aligned_alloc(4, pool->buffer_size, MALLOC_CAP_DMA);
+        if (pool->buffers[i] == NULL) {
+            while (i-- > 0) {
+                heap_caps_free(pool->buffers[i]);
+                pool->buffers[i] = NULL;
+            }
+            return NHAL_ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    pool->num_buffers = num_buffers;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_dma_pool_deinit(struct nhal_spi_dma_pool *pool) {
+    if (pool == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (pool->in_use != 0) {
+        return NHAL_ERR_BUSY;
+    }
+
+    for (size_t i = 0; i < pool->num_buffers; i++) {
+        heap_caps_free(pool->buffers[i]);
+        pool->buffers[i] = NULL;
+    }
+    pool->num_buffers = 0;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_dma_pool_borrow(struct nhal_spi_dma_pool *pool, uint8_t **buffer) {
+    if (pool == NULL || buffer == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_result_t result = NHAL_ERR_BUSY;
+
+    portENTER_CRITICAL(&pool->lock);
+    for (size_t i = 0; i < pool->num_buffers; i++) {
+        if ((pool->in_use & (1u << i)) == 0) {
+            pool->in_use |= (1u << i);
+            *buffer = pool->buffers[i];
+            result = NHAL_OK;
+            break;
+        }
+    }
+
+    if (result == NHAL_OK) {
+        uint32_t in_use = (uint32_t)__builtin_popcount(pool->in_use);
+        pool->stats.borrowed++;
+        if (in_use > pool->stats.max_in_use) {
+            pool->stats.max_in_use = in_use;
+        }
+    } else {
+        pool->stats.exhausted++;
+    }
+    portEXIT_CRITICAL(&pool->lock);
+
+    return result;
+}
+
+nhal_result_t nhal_esp32_spi_dma_pool_return(struct nhal_spi_dma_pool *pool, uint8_t *buffer) {
+    if (pool == NULL || buffer == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    for (size_t i = 0; i < pool->num_buffers; i++) {
+        if (pool->buffers[i] == buffer) {
+            portENTER_CRITICAL(&pool->lock);
+            pool->in_use &= ~(1u << i);
+            portEXIT_CRITICAL(&pool->lock);
+            return NHAL_OK;
+        }
+    }
+
+    return NHAL_ERR_INVALID_ARG;
+}
+
+nhal_result_t nhal_esp32_spi_dma_pool_get_stats(struct nhal_spi_dma_pool *pool, struct nhal_spi_dma_pool_stats *stats) {
+    if (pool == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&pool->lock, stats, &pool->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_dma_pool_reset_stats(struct nhal_spi_dma_pool *pool) {
+    if (pool == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&pool->lock, &pool->stats, sizeof(pool->stats));
+    return NHAL_OK;
+}
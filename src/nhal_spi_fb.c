@@ -0,0 +1,361 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_helpers.h"
+#include "nhal_esp32_spi.h"
+#include "nhal_esp32_spi_fb.h"
+#include "nhal_esp32_spi_internal.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_spi_types.h"
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+
+#include <string.h>
+
+// MIPI DCS window and memory write commands
+#define NHAL_FB_CMD_CASET 0x2A
+#define NHAL_FB_CMD_RASET 0x2B
+#define NHAL_FB_CMD_RAMWR 0x2C
+
+static void IRAM_ATTR nhal_fb_pre(spi_transaction_t *trans) {
+    struct nhal_spi_fb_desc *desc = (struct nhal_spi_fb_desc *)trans->user;
+    gpio_set_level(desc->dc_pin, desc->dc_level);
+}
+
+static nhal_result_t nhal_fb_submit(struct nhal_spi_fb *fb, size_t slot, size_t len, uint32_t dc_level) {
+    struct nhal_spi_context *ctx = fb->ctx;
+    struct nhal_spi_fb_desc *desc = &fb->descs[slot];
+
+    memset(desc, 0, sizeof(*desc));
+    desc->hook.ctx = ctx;
+    desc->hook.pre = nhal_fb_pre;
+    desc->dc_pin = fb->config.dc_pin;
+    desc->dc_level = dc_level;
+    desc->trans.length = len * 8; // Length in bits
+    desc->trans.tx_buffer = fb->buffers[slot];
+    desc->trans.user = &desc->hook;
+    desc->submit_us = nhal_get_timestamp_microseconds();
+
+    esp_err_t ret_err = spi_device_queue_trans(ctx->device_handle, &desc->trans, pdMS_TO_TICKS(ctx->timeout_ms));
+    if (ret_err != ESP_OK) {
+        return nhal_map_esp_err(ret_err);
+    }
+    desc->in_flight = true;
+    return NHAL_OK;
+}
+
+// Collects the oldest transaction in flight
+static nhal_result_t nhal_fb_wait(struct nhal_spi_fb *fb) {
+    struct nhal_spi_context *ctx = fb->ctx;
+    spi_transaction_t *trans = NULL;
+
+    esp_err_t ret_err = spi_device_get_trans_result(ctx->device_handle, &trans, pdMS_TO_TICKS(ctx->timeout_ms));
+    if (ret_err != ESP_OK) {
+        return nhal_map_esp_err(ret_err);
+    }
+    if (trans == NULL) {
+        return NHAL_ERR_OTHER;
+    }
+
+    struct nhal_spi_fb_desc *desc = (struct nhal_spi_fb_desc *)trans->user;
+    nhal_spi_stats_record(ctx, trans->length / 8, desc->hook.end_us - desc->submit_us, &desc->hook, NHAL_OK);
+    desc->in_flight = false;
+    return NHAL_OK;
+}
+
+/**
+ * Collects everything in flight. A descriptor whose wait failed stays in
+ * flight, still owned by the driver; every entry point drains before it
+ * submits, so it is never reused until it has been collected.
+ */
+static nhal_result_t nhal_fb_drain(struct nhal_spi_fb *fb) {
+    for (size_t i = 0; i < 2; i++) {
+        if (fb->descs[0].in_flight || fb->descs[1].in_flight) {
+            nhal_result_t result = nhal_fb_wait(fb);
+            if (result != NHAL_OK) {
+                return result;
+            }
+        }
+    }
+    return NHAL_OK;
+}
+
+static nhal_result_t nhal_fb_command_locked(struct nhal_spi_fb *fb, uint8_t command, const uint8_t *params, size_t len) {
+    // Both halves are queued back to back; D/C flips in the second pre callback
+    fb->buffers[0][0] = command;
+    nhal_result_t result = nhal_fb_submit(fb, 0, 1, 0);
+    if (result == NHAL_OK && len > 0) {
+        memcpy(fb->buffers[1], params, len);
+        result = nhal_fb_submit(fb, 1, len, 1);
+    }
+
+    nhal_result_t drain_result = nhal_fb_drain(fb);
+    return (result != NHAL_OK) ? result : drain_result;
+}
+
+static nhal_result_t nhal_fb_set_window(struct nhal_spi_fb *fb, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    uint16_t x_end = x + w - 1;
+    uint16_t y_end = y + h - 1;
+    uint8_t columns[4] = { x >> 8, x & 0xFF, x_end >> 8, x_end & 0xFF };
+    uint8_t rows[4] = { y >> 8, y & 0xFF, y_end >> 8, y_end & 0xFF };
+
+    nhal_result_t result = nhal_fb_command_locked(fb, NHAL_FB_CMD_CASET, columns, sizeof(columns));
+    if (result == NHAL_OK) {
+        result = nhal_fb_command_locked(fb, NHAL_FB_CMD_RASET, rows, sizeof(rows));
+    }
+    if (result == NHAL_OK) {
+        result = nhal_fb_command_locked(fb, NHAL_FB_CMD_RAMWR, NULL, 0);
+    }
+    return result;
+}
+
+/**
+ * Copies up to max_pixels pixels of the region into dst, continuing from
+ * (*row, *col); returns the number copied.
+ */
+static size_t nhal_fb_fill(
+    const struct nhal_spi_fb *fb, uint8_t *dst,
+    const uint16_t *pixels, size_t stride,
+    uint16_t w, uint16_t h,
+    uint16_t *row, uint16_t *col,
+    size_t max_pixels
+) {
+    size_t filled = 0;
+    while (filled < max_pixels && *row < h) {
+        size_t run = w - *col;
+        if (run > max_pixels - filled) {
+            run = max_pixels - filled;
+        }
+
+        const uint16_t *src = pixels + (size_t)*row * stride + *col;
+        uint8_t *out = dst + filled * 2;
+        if (fb->config.swap_bytes) {
+            for (size_t i = 0; i < run; i++) {
+                out[2 * i] = (uint8_t)(src[i] >> 8);
+                out[2 * i + 1] = (uint8_t)src[i];
+            }
+        } else {
+            memcpy(out, src, run * 2);
+        }
+
+        filled += run;
+        *col += run;
+        if (*col == w) {
+            *col = 0;
+            (*row)++;
+        }
+    }
+    return filled;
+}
+
+nhal_result_t nhal_esp32_spi_fb_init(
+    struct nhal_spi_fb *fb,
+    struct nhal_spi_context *ctx,
+    const struct nhal_spi_fb_config *config
+) {
+    if (fb == NULL || ctx == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    // Window commands carry 4 parameter bytes
+    if ((config->chunk_size & 1u) != 0 || (config->chunk_size > 0 && config->chunk_size < 4)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    // One chunk on the wire while the next is queued
+    if (ctx->queue_size < 2) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (fb->is_initialized) {
+        return NHAL_OK;
+    }
+
+    memset(fb, 0, sizeof(*fb));
+    portMUX_INITIALIZE(&fb->stats_lock);
+    fb->ctx = ctx;
+    fb->config = *config;
+    if (fb->config.chunk_size == 0) {
+        fb->config.chunk_size = NHAL_ESP32_SPI_FB_CHUNK_SIZE;
+    }
+
+    gpio_config_t dc_config = {
+        .pin_bit_mask = 1ULL << config->dc_pin,
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    esp_err_t ret_err = gpio_config(&dc_config);
+    if (ret_err != ESP_OK) {
+        return nhal_map_esp_err(ret_err);
+    }
+
+    for (size_t i = 0; i < 2; i++) {
+        fb->buffers[i] = heap_caps_aligned_alloc(4, fb->config.chunk_size, MALLOC_CAP_DMA);
+        if (fb->buffers[i] == NULL) {
+            heap_caps_free(fb->buffers[0]);
+            fb->buffers[0] = NULL;
+            return NHAL_ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    fb->is_initialized = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_fb_deinit(struct nhal_spi_fb *fb) {
+    if (fb == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!fb->is_initialized) {
+        return NHAL_OK;
+    }
+
+    // The driver may still be reading a buffer
+    nhal_result_t result = nhal_fb_drain(fb);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    for (size_t i = 0; i < 2; i++) {
+        heap_caps_free(fb->buffers[i]);
+        fb->buffers[i] = NULL;
+    }
+    fb->is_initialized = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_fb_command(
+    struct nhal_spi_fb *fb,
+    uint8_t command,
+    const uint8_t *params, size_t len
+) {
+    if (fb == NULL || (params == NULL && len > 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!fb->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (len > fb->config.chunk_size) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_result_t result = nhal_esp32_spi_acquire(fb->ctx);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    result = nhal_fb_drain(fb);
+    if (result == NHAL_OK) {
+        result = nhal_fb_command_locked(fb, command, params, len);
+    }
+    nhal_esp32_spi_release(fb->ctx);
+    return result;
+}
+
+nhal_result_t nhal_esp32_spi_fb_draw(
+    struct nhal_spi_fb *fb,
+    uint16_t x, uint16_t y,
+    uint16_t w, uint16_t h,
+    const uint16_t *pixels, size_t stride
+) {
+    if (fb == NULL || pixels == NULL || w == 0 || h == 0 || stride < w) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!fb->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_result_t result = nhal_esp32_spi_acquire(fb->ctx);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    uint64_t start_us = nhal_get_timestamp_microseconds();
+    uint64_t cpu_us = 0;
+    uint32_t chunks = 0;
+
+    // Left over from a draw whose wait failed
+    result = nhal_fb_drain(fb);
+    if (result == NHAL_OK) {
+        result = nhal_fb_set_window(fb, x, y, w, h);
+    }
+
+    size_t pixels_per_chunk = fb->config.chunk_size / 2;
+    uint16_t row = 0;
+    uint16_t col = 0;
+    size_t slot = 0;
+    while (result == NHAL_OK && row < h) {
+        // Slots alternate, so a busy slot holds the oldest transaction
+        if (fb->descs[slot].in_flight) {
+            result = nhal_fb_wait(fb);
+            if (result != NHAL_OK) {
+                break;
+            }
+        }
+
+        uint64_t fill_start_us = nhal_get_timestamp_microseconds();
+        size_t filled = nhal_fb_fill(fb, fb->buffers[slot], pixels, stride, w, h, &row, &col, pixels_per_chunk);
+        result = nhal_fb_submit(fb, slot, filled * 2, 1);
+        cpu_us += nhal_get_timestamp_microseconds() - fill_start_us;
+
+        chunks++;
+        slot ^= 1;
+    }
+
+    nhal_result_t drain_result = nhal_fb_drain(fb);
+    if (result == NHAL_OK) {
+        result = drain_result;
+    }
+    nhal_esp32_spi_release(fb->ctx);
+
+    uint64_t frame_us = nhal_get_timestamp_microseconds() - start_us;
+    if (result == NHAL_OK) {
+        portENTER_CRITICAL(&fb->stats_lock);
+        fb->stats.frames++;
+        fb->stats.chunks += chunks;
+        fb->stats.bytes += (uint64_t)w * h * 2;
+        fb->stats.frame_time_us += frame_us;
+        fb->stats.cpu_time_us += cpu_us;
+        if (frame_us > fb->stats.max_frame_us) {
+            fb->stats.max_frame_us = (uint32_t)frame_us;
+        }
+        portEXIT_CRITICAL(&fb->stats_lock);
+    }
+    return result;
+}
+
+nhal_result_t nhal_esp32_spi_fb_get_stats(struct nhal_spi_fb *fb, struct nhal_spi_fb_stats *stats) {
+    if (fb == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&fb->stats_lock, stats, &fb->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_fb_reset_stats(struct nhal_spi_fb *fb) {
+    if (fb == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&fb->stats_lock, &fb->stats, sizeof(fb->stats));
+    return NHAL_OK;
+}
@@ -0,0 +1,221 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_helpers.h"
+#include "nhal_esp32_spi_internal.h"
+#include "nhal_esp32_spi_queue.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_spi_types.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "driver/spi_master.h"
+
+#include <string.h>
+
+static void IRAM_ATTR nhal_spi_queue_post(spi_transaction_t *trans) {
+    struct nhal_spi_queue_desc *desc = (struct nhal_spi_queue_desc *)trans->user;
+    if (desc->callback != NULL) {
+        desc->callback(desc->id, desc->user_data);
+    }
+}
+
+static void nhal_spi_queue_unlock(struct nhal_spi_queue *queue) {
+    queue->holds_lock = false;
+    if (queue->took_mutex) {
+        xSemaphoreGive(queue->ctx->mutex);
+    }
+}
+
+static void nhal_spi_queue_count(struct nhal_spi_queue *queue, uint32_t *counter) {
+    portENTER_CRITICAL(&queue->stats_lock);
+    (*counter)++;
+    portEXIT_CRITICAL(&queue->stats_lock);
+}
+
+nhal_result_t nhal_esp32_spi_queue_init(struct nhal_spi_queue *queue, struct nhal_spi_context *ctx) {
+    if (queue == NULL || ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    memset(queue, 0, sizeof(*queue));
+    portMUX_INITIALIZE(&queue->stats_lock);
+    queue->ctx = ctx;
+    queue->depth = ctx->queue_size;
+    if (queue->depth > NHAL_ESP32_SPI_QUEUE_MAX_DESCRIPTORS) {
+        queue->depth = NHAL_ESP32_SPI_QUEUE_MAX_DESCRIPTORS;
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_queue_submit(
+    struct nhal_spi_queue *queue,
+    const uint8_t *tx_data, uint8_t *rx_data, size_t len,
+    nhal_spi_queue_callback_t callback, void *user_data,
+    uint32_t *id
+) {
+    if (queue == NULL || queue->ctx == NULL || len == 0 || (tx_data == NULL && rx_data == NULL)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_spi_context *ctx = queue->ctx;
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    if (queue->holds_lock && queue->owner != self) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_spi_queue_desc *desc = NULL;
+    for (size_t i = 0; i < queue->depth; i++) {
+        if (!queue->descs[i].in_use) {
+            desc = &queue->descs[i];
+            break;
+        }
+    }
+    if (desc == NULL) {
+        nhal_spi_queue_count(queue, &queue->stats.rejected);
+        return NHAL_ERR_BUSY;
+    }
+
+    // A task that acquired the bus already holds the mutex; only what was
+    // actually taken here is given back
+    if (!queue->holds_lock) {
+        bool owner = nhal_spi_is_bus_owner(ctx);
+        if (nhal_spi_lock(ctx) != pdTRUE) {
+            return NHAL_ERR_BUSY;
+        }
+        queue->holds_lock = true;
+        queue->took_mutex = !owner;
+        queue->owner = self;
+    }
+
+    memset(desc, 0, sizeof(*desc));
+    desc->hook.ctx = ctx;
+    desc->hook.post = nhal_spi_queue_post;
+    desc->trans.length = len * 8; // Length in bits
+    desc->trans.tx_buffer = tx_data;
+    desc->trans.rx_buffer = rx_data;
+    desc->trans.user = &desc->hook;
+    desc->callback = callback;
+    desc->user_data = user_data;
+    desc->id = queue->next_id;
+    desc->len = len;
+    desc->submit_us = nhal_get_timestamp_microseconds();
+
+    esp_err_t ret_err = spi_device_queue_trans(ctx->device_handle, &desc->trans, 0);
+    if (ret_err != ESP_OK) {
+        if (queue->in_flight == 0) {
+            nhal_spi_queue_unlock(queue);
+        }
+        nhal_spi_queue_count(queue, &queue->stats.rejected);
+        return (ret_err == ESP_ERR_TIMEOUT) ? NHAL_ERR_BUSY : nhal_map_esp_err(ret_err);
+    }
+
+    desc->in_use = true;
+    queue->next_id++;
+    queue->in_flight++;
+    portENTER_CRITICAL(&queue->stats_lock);
+    queue->stats.submitted++;
+    if (queue->in_flight > queue->stats.max_in_flight) {
+        queue->stats.max_in_flight = queue->in_flight;
+    }
+    portEXIT_CRITICAL(&queue->stats_lock);
+
+    if (id != NULL) {
+        *id = desc->id;
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_queue_collect(
+    struct nhal_spi_queue *queue,
+    nhal_timeout_ms timeout_ms,
+    struct nhal_spi_queue_result *result
+) {
+    if (queue == NULL || result == NULL || queue->in_flight == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    // The lock has to be given back by the task that took it
+    if (queue->owner != xTaskGetCurrentTaskHandle()) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_spi_context *ctx = queue->ctx;
+    spi_transaction_t *trans = NULL;
+
+    esp_err_t ret_err = spi_device_get_trans_result(ctx->device_handle, &trans, pdMS_TO_TICKS(timeout_ms));
+    if (ret_err == ESP_ERR_TIMEOUT) {
+        return NHAL_ERR_TIMEOUT;
+    }
+    if (ret_err != ESP_OK || trans == NULL) {
+        return nhal_map_esp_err(ret_err);
+    }
+
+    struct nhal_spi_queue_desc *desc = (struct nhal_spi_queue_desc *)trans->user;
+
+    // Queued transactions have no caller waiting on them, so the time from
+    // submission to completion is what gets accounted.
+    uint64_t elapsed_us = desc->hook.end_us - desc->submit_us;
+    nhal_spi_stats_record(ctx, desc->len, elapsed_us, &desc->hook, NHAL_OK);
+
+    result->id = desc->id;
+    result->result = NHAL_OK;
+    result->user_data = desc->user_data;
+
+    desc->in_use = false;
+    queue->in_flight--;
+    nhal_spi_queue_count(queue, &queue->stats.completed);
+
+    if (queue->in_flight == 0 && queue->holds_lock) {
+        nhal_spi_queue_unlock(queue);
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_queue_drain(struct nhal_spi_queue *queue) {
+    if (queue == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_result_t drain_result = NHAL_OK;
+    while (queue->in_flight > 0) {
+        struct nhal_spi_queue_result result;
+        nhal_result_t collect_result = nhal_esp32_spi_queue_collect(queue, queue->ctx->timeout_ms, &result);
+        if (collect_result != NHAL_OK) {
+            return collect_result;
+        }
+        if (result.result != NHAL_OK && drain_result == NHAL_OK) {
+            drain_result = result.result;
+        }
+    }
+    return drain_result;
+}
+
+nhal_result_t nhal_esp32_spi_queue_get_stats(struct nhal_spi_queue *queue, struct nhal_spi_queue_stats *stats) {
+    if (queue == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&queue->stats_lock, stats, &queue->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_queue_reset_stats(struct nhal_spi_queue *queue) {
+    if (queue == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&queue->stats_lock, &queue->stats, sizeof(queue->stats));
+    return NHAL_OK;
+}
@@ -0,0 +1,278 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_helpers.h"
+#include "nhal_esp32_spi_slave.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_pin.h"
+#include "nhal_pin_types.h"
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "driver/spi_slave.h"
+
+#include <string.h>
+
+static void IRAM_ATTR nhal_spi_slave_post_setup(spi_slave_transaction_t *trans) {
+    struct nhal_spi_slave_desc *desc = (struct nhal_spi_slave_desc *)trans->user;
+    if (desc->slave->ready_gpio != GPIO_NUM_NC) {
+        gpio_set_level(desc->slave->ready_gpio, 1);
+    }
+}
+
+static void IRAM_ATTR nhal_spi_slave_post_trans(spi_slave_transaction_t *trans) {
+    struct nhal_spi_slave_desc *desc = (struct nhal_spi_slave_desc *)trans->user;
+    desc->done_us = esp_timer_get_time();
+    if (desc->slave->ready_gpio != GPIO_NUM_NC) {
+        gpio_set_level(desc->slave->ready_gpio, 0);
+    }
+}
+
+static void nhal_spi_slave_put_header(uint8_t *frame, uint16_t sequence, uint16_t len) {
+    frame[0] = (uint8_t)sequence;
+    frame[1] = (uint8_t)(sequence >> 8);
+    frame[2] = (uint8_t)len;
+    frame[3] = (uint8_t)(len >> 8);
+}
+
+static void nhal_spi_slave_free_buffers(struct nhal_spi_slave *slave) {
+    for (size_t i = 0; i < NHAL_ESP32_SPI_SLAVE_MAX_DEPTH; i++) {
+        heap_caps_free(slave->descs[i].tx);
+        heap_caps_free(slave->descs[i].rx);
+        slave->descs[i].tx = NULL;
+        slave->descs[i].rx = NULL;
+    }
+}
+
+nhal_result_t nhal_esp32_spi_slave_start(struct nhal_spi_slave *slave, const struct nhal_spi_slave_config *config) {
+    if (slave == NULL || config == NULL || config->mode > 3 || config->depth > NHAL_ESP32_SPI_SLAVE_MAX_DEPTH) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    // DMA moves whole words
+    if (config->frame_size != 0 &&
+        ((config->frame_size & 3u) != 0 || config->frame_size <= NHAL_ESP32_SPI_SLAVE_HEADER_SIZE)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (config->ready_pin != NULL && !config->ready_pin->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    if (slave->is_running) {
+        return NHAL_ERR_BUSY;
+    }
+
+    memset(slave, 0, sizeof(*slave));
+    portMUX_INITIALIZE(&slave->stats_lock);
+    slave->config = *config;
+    if (slave->config.frame_size == 0) {
+        slave->config.frame_size = NHAL_ESP32_SPI_SLAVE_FRAME_SIZE;
+    }
+    if (slave->config.depth == 0) {
+        slave->config.depth = NHAL_ESP32_SPI_SLAVE_MAX_DEPTH;
+    }
+    slave->ready_gpio = (config->ready_pin != NULL) ? config->ready_pin->pin_num : GPIO_NUM_NC;
+
+    for (size_t i = 0; i < slave->config.depth; i++) {
+        struct nhal_spi_slave_desc *desc = &slave->descs[i];
+        desc->tx = heap_caps_aligned_alloc(4, slave->config.frame_size, MALLOC_CAP_DMA);
+        desc->rx = heap_caps_aligned_alloc(4, slave->config.frame_size, MALLOC_CAP_DMA);
+        if (desc->tx == NULL || desc->rx == NULL) {
+            nhal_spi_slave_free_buffers(slave);
+            return NHAL_ERR_OUT_OF_MEMORY;
+        }
+        desc->slave = slave;
+    }
+
+    if (config->ready_pin != NULL) {
+        nhal_pin_set_state(config->ready_pin, NHAL_PIN_LOW);
+    }
+
+    spi_bus_config_t bus_config = {0};
+    bus_config.mosi_io_num = config->mosi_pin;
+    bus_config.miso_io_num = config->miso_pin;
+    bus_config.sclk_io_num = config->sclk_pin;
+    bus_config.quadwp_io_num = -1;
+    bus_config.quadhd_io_num = -1;
+    bus_config.max_transfer_sz = slave->config.frame_size;
+
+    spi_slave_interface_config_t slave_config = {0};
+    slave_config.spics_io_num = config->cs_pin;
+    slave_config.mode = config->mode;
+    slave_config.queue_size = slave->config.depth;
+    slave_config.post_setup_cb = nhal_spi_slave_post_setup;
+    slave_config.post_trans_cb = nhal_spi_slave_post_trans;
+
+    esp_err_t ret_err = spi_slave_initialize(config->spi_bus_id, &bus_config, &slave_config, SPI_DMA_CH_AUTO);
+    if (ret_err != ESP_OK) {
+        nhal_spi_slave_free_buffers(slave);
+        return nhal_map_esp_err(ret_err);
+    }
+
+    slave->is_running = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_slave_stop(struct nhal_spi_slave *slave) {
+    if (slave == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!slave->is_running) {
+        return NHAL_OK;
+    }
+
+    esp_err_t ret_err = spi_slave_free(slave->config.spi_bus_id);
+    if (ret_err != ESP_OK) {
+        return nhal_map_esp_err(ret_err);
+    }
+
+    if (slave->config.ready_pin != NULL) {
+        nhal_pin_set_state(slave->config.ready_pin, NHAL_PIN_LOW);
+    }
+
+    nhal_spi_slave_free_buffers(slave);
+    slave->posted = 0;
+    slave->is_running = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_slave_post(struct nhal_spi_slave *slave, const uint8_t *data, size_t len) {
+    if (slave == NULL || (data == NULL && len > 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!slave->is_running) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (len > slave->config.frame_size - NHAL_ESP32_SPI_SLAVE_HEADER_SIZE) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (slave->posted == slave->config.depth) {
+        return NHAL_ERR_BUSY;
+    }
+
+    struct nhal_spi_slave_desc *desc = &slave->descs[slave->next_post];
+    nhal_spi_slave_put_header(desc->tx, slave->tx_sequence, (uint16_t)len);
+    if (len > 0) {
+        memcpy(desc->tx + NHAL_ESP32_SPI_SLAVE_HEADER_SIZE, data, len);
+    }
+
+    memset(&desc->trans, 0, sizeof(desc->trans));
+    desc->trans.length = slave->config.frame_size * 8; // Length in bits
+    desc->trans.tx_buffer = desc->tx;
+    desc->trans.rx_buffer = desc->rx;
+    desc->trans.user = desc;
+    desc->done_us = 0;
+
+    esp_err_t ret_err = spi_slave_queue_trans(slave->config.spi_bus_id, &desc->trans, 0);
+    if (ret_err != ESP_OK) {
+        return (ret_err == ESP_ERR_TIMEOUT) ? NHAL_ERR_BUSY : nhal_map_esp_err(ret_err);
+    }
+
+    slave->tx_sequence++;
+    slave->next_post = (slave->next_post + 1) % slave->config.depth;
+    slave->posted++;
+    portENTER_CRITICAL(&slave->stats_lock);
+    if (slave->posted > slave->stats.max_posted) {
+        slave->stats.max_posted = slave->posted;
+    }
+    slave->stats.bytes_sent += len;
+    portEXIT_CRITICAL(&slave->stats_lock);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_slave_collect(
+    struct nhal_spi_slave *slave,
+    nhal_timeout_ms timeout_ms,
+    uint8_t *data, size_t capacity,
+    size_t *len, uint16_t *sequence
+) {
+    if (slave == NULL || data == NULL || len == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!slave->is_running) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    size_t max_payload = slave->config.frame_size - NHAL_ESP32_SPI_SLAVE_HEADER_SIZE;
+    if (capacity < max_payload || slave->posted == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    spi_slave_transaction_t *trans = NULL;
+    esp_err_t ret_err = spi_slave_get_trans_result(slave->config.spi_bus_id, &trans, pdMS_TO_TICKS(timeout_ms));
+    if (ret_err != ESP_OK || trans == NULL) {
+        return nhal_map_esp_err(ret_err);
+    }
+
+    struct nhal_spi_slave_desc *desc = (struct nhal_spi_slave_desc *)trans->user;
+    slave->posted--;
+    portENTER_CRITICAL(&slave->stats_lock);
+    slave->stats.frames_sent++;
+    if (slave->stats.first_done_us == 0) {
+        slave->stats.first_done_us = desc->done_us;
+    }
+    slave->stats.last_done_us = desc->done_us;
+    portEXIT_CRITICAL(&slave->stats_lock);
+
+    *len = 0;
+    const uint8_t *frame = desc->rx;
+    uint16_t rx_sequence = (uint16_t)(frame[0] | (frame[1] << 8));
+    uint16_t rx_len = (uint16_t)(frame[2] | (frame[3] << 8));
+
+    // The host may end the transaction early; the payload must have arrived
+    size_t received = trans->trans_len / 8;
+    if (received < NHAL_ESP32_SPI_SLAVE_HEADER_SIZE || rx_len > max_payload ||
+        received < NHAL_ESP32_SPI_SLAVE_HEADER_SIZE + (size_t)rx_len) {
+        portENTER_CRITICAL(&slave->stats_lock);
+        slave->stats.frame_errors++;
+        portEXIT_CRITICAL(&slave->stats_lock);
+        return NHAL_ERR_OTHER;
+    }
+
+    if (slave->rx_synced && rx_sequence != slave->rx_sequence) {
+        portENTER_CRITICAL(&slave->stats_lock);
+        slave->stats.sequence_errors++;
+        slave->stats.frames_lost += (uint16_t)(rx_sequence - slave->rx_sequence);
+        portEXIT_CRITICAL(&slave->stats_lock);
+    }
+    slave->rx_sequence = rx_sequence + 1;
+    slave->rx_synced = true;
+
+    memcpy(data, frame + NHAL_ESP32_SPI_SLAVE_HEADER_SIZE, rx_len);
+    *len = rx_len;
+    if (sequence != NULL) {
+        *sequence = rx_sequence;
+    }
+    portENTER_CRITICAL(&slave->stats_lock);
+    slave->stats.frames_received++;
+    slave->stats.bytes_received += rx_len;
+    portEXIT_CRITICAL(&slave->stats_lock);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_slave_get_stats(struct nhal_spi_slave *slave, struct nhal_spi_slave_stats *stats) {
+    if (slave == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&slave->stats_lock, stats, &slave->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_spi_slave_reset_stats(struct nhal_spi_slave *slave) {
+    if (slave == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&slave->stats_lock, &slave->stats, sizeof(slave->stats));
+    return NHAL_OK;
+}
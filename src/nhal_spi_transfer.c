@@ -0,0 +1,180 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_spi.h"
+#include "nhal_esp32_spi_internal.h"
+#include "nhal_esp32_spi_transfer.h"
+
+#include "nhal_common.h"
+#include "nhal_spi_types.h"
+
+#include "driver/spi_master.h"
+
+// Widest dummy phase a single driver transaction can carry
+#define NHAL_SPI_TRANSFER_MAX_DUMMY 255u
+
+static bool nhal_spi_segment_valid(const nhal_spi_segment_t *segment) {
+    switch (segment->type) {
+        case NHAL_SPI_SEGMENT_TX:
+            return segment->tx != NULL && segment->length > 0;
+        case NHAL_SPI_SEGMENT_RX:
+            return segment->rx != NULL && segment->length > 0;
+        case NHAL_SPI_SEGMENT_TX_RX:
+            return segment->tx != NULL && segment->rx != NULL && segment->length > 0;
+        case NHAL_SPI_SEGMENT_DUMMY:
+            return segment->dummy_cycles > 0;
+        default:
+            return false;
+    }
+}
+
+static uint8_t nhal_spi_lines(uint8_t lines) {
+    return (lines == 0) ? 1 : lines;
+}
+
+// Maps the header line widths onto driver transaction flags
+static bool nhal_spi_line_flags(const struct nhal_spi_transfer_header *header, uint32_t *flags) {
+    *flags = 0;
+    if (header == NULL) {
+        return true;
+    }
+
+    uint8_t data_lines = nhal_spi_lines(header->data_lines);
+    uint8_t command_lines = nhal_spi_lines(header->command_lines);
+    uint8_t address_lines = nhal_spi_lines(header->address_lines);
+
+    if (data_lines == 2) {
+        *flags |= SPI_TRANS_MODE_DIO;
+    } else if (data_lines == 4) {
+        *flags |= SPI_TRANS_MODE_QIO;
+    } else if (data_lines != 1) {
+        return false;
+    }
+
+    if (command_lines != 1) {
+        if (command_lines != data_lines) {
+            return false;
+        }
+        *flags |= SPI_TRANS_MULTILINE_CMD;
+    }
+    if (address_lines != 1) {
+        if (address_lines != data_lines) {
+            return false;
+        }
+        *flags |= SPI_TRANS_MULTILINE_ADDR;
+    }
+    return true;
+}
+
+static bool nhal_spi_segments_valid(const nhal_spi_segment_t *segments, size_t num_segments, bool multiline) {
+    // Consecutive dummy segments merge into the dummy phase of one transaction
+    uint32_t dummy_cycles = 0;
+    for (size_t i = 0; i < num_segments; i++) {
+        if (!nhal_spi_segment_valid(&segments[i])) {
+            return false;
+        }
+        // Dual and quad data lines only carry one direction at a time
+        if (multiline && segments[i].type == NHAL_SPI_SEGMENT_TX_RX) {
+            return false;
+        }
+        if (segments[i].type == NHAL_SPI_SEGMENT_DUMMY) {
+            dummy_cycles += segments[i].dummy_cycles;
+            if (dummy_cycles > NHAL_SPI_TRANSFER_MAX_DUMMY) {
+                return false;
+            }
+        } else {
+            dummy_cycles = 0;
+        }
+    }
+    return true;
+}
+
+nhal_result_t nhal_esp32_spi_transfer(
+    struct nhal_spi_context *ctx,
+    const struct nhal_spi_transfer_header *header,
+    const nhal_spi_segment_t *segments,
+    size_t num_segments
+) {
+    if (ctx == NULL || (segments == NULL && num_segments > 0) || (header == NULL && num_segments == 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (header != NULL && (header->command_bits > 16 || header->address_bits > 64)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    uint32_t line_flags;
+    if (!nhal_spi_line_flags(header, &line_flags)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    uint8_t data_lines = (header != NULL) ? nhal_spi_lines(header->data_lines) : 1;
+    if (!nhal_spi_segments_valid(segments, num_segments, data_lines > 1)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    // CS_KEEP_ACTIVE is only honoured while the device holds the bus
+    nhal_result_t result = nhal_esp32_spi_acquire(ctx);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    if (data_lines > ctx->data_lines || (data_lines > 1 && !ctx->half_duplex)) {
+        nhal_esp32_spi_release(ctx);
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    size_t next = 0;
+    bool first = true;
+    bool cs_held = false;
+    do {
+        spi_transaction_ext_t ext = {0};
+        ext.base.flags = line_flags;
+
+        if (first && header != NULL) {
+            ext.base.flags |= SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR;
+            ext.base.cmd = header->command;
+            ext.command_bits = header->command_bits;
+            ext.base.addr = header->address;
+            ext.address_bits = header->address_bits;
+        }
+
+        uint32_t dummy_cycles = 0;
+        while (next < num_segments && segments[next].type == NHAL_SPI_SEGMENT_DUMMY) {
+            dummy_cycles += segments[next++].dummy_cycles;
+        }
+        if (dummy_cycles > 0) {
+            ext.base.flags |= SPI_TRANS_VARIABLE_DUMMY;
+            ext.dummy_bits = (uint8_t)dummy_cycles;
+        }
+
+        const nhal_spi_segment_t *segment = (next < num_segments) ? &segments[next++] : NULL;
+        if (next < num_segments) {
+            ext.base.flags |= SPI_TRANS_CS_KEEP_ACTIVE;
+        }
+
+        const uint8_t *tx = NULL;
+        uint8_t *rx = NULL;
+        size_t len = 0;
+        if (segment != NULL) {
+            tx = (segment->type == NHAL_SPI_SEGMENT_RX) ? NULL : segment->tx;
+            rx = (segment->type == NHAL_SPI_SEGMENT_TX) ? NULL : segment->rx;
+            len = segment->length;
+        }
+
+        // A failed segment may have asserted CS itself before it gave up
+        bool keep = (ext.base.flags & SPI_TRANS_CS_KEEP_ACTIVE) != 0;
+        result = nhal_spi_transmit_ext_locked(ctx, &ext, tx, rx, len * 8);
+        cs_held = (result == NHAL_OK) ? keep : (cs_held || keep);
+        first = false;
+    } while (result == NHAL_OK && next < num_segments);
+
+    if (cs_held) {
+        // A segment failed with CS possibly still asserted: an empty
+        // transaction without CS_KEEP_ACTIVE ends the frame before the bus
+        // is released
+        spi_transaction_t end = {0};
+        spi_device_polling_transmit(ctx->device_handle, &end);
+    }
+
+    nhal_esp32_spi_release(ctx);
+    return result;
+}
@@ -0,0 +1,17 @@
+#include "nhal_esp32_stats.h"
+
+#include "freertos/FreeRTOS.h"
+
+#include <string.h>
+
+void nhal_stats_copy(portMUX_TYPE *lock, void *dst, const void *stats, size_t size) {
+    portENTER_CRITICAL(lock);
+    memcpy(dst, stats, size);
+    portEXIT_CRITICAL(lock);
+}
+
+void nhal_stats_clear(portMUX_TYPE *lock, void *stats, size_t size) {
+    portENTER_CRITICAL(lock);
+    memset(stats, 0, size);
+    portEXIT_CRITICAL(lock);
+}
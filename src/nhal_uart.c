@@ -1,15 +1,22 @@
 #include "nhal_esp32_defs.h"
 #include "nhal_esp32_helpers.h"
+#include "nhal_esp32_uart.h"
+#include "nhal_esp32_uart_internal.h"
+#include "nhal_esp32_uart_rs485.h"
+#include "nhal_esp32_stats.h"
 
 #include <nhal_uart.h>
 #include <nhal_uart_types.h>
 
+#include "driver/gpio.h"
 #include "driver/uart.h"
 #include "esp_err.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+#include <string.h>
+
 static void nhal_config_to_esp_config(struct nhal_uart_config *config, uart_config_t *esp_config) {
     esp_config->baud_rate = config->baudrate;
 
@@ -46,12 +53,32 @@ static void nhal_config_to_esp_config(struct nhal_uart_config *config, uart_conf
             break;
     }
 
-    esp_config->flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
-    esp_config->rx_flow_ctrl_thresh = 0;
-    esp_config->source_clk = UART_SCLK_DEFAULT;
+    struct nhal_uart_impl_config *impl_cfg = (struct nhal_uart_impl_config *)config->impl_config;
+
+    esp_config->flow_ctrl = (uart_hw_flowcontrol_t)impl_cfg->flow_ctrl;
+    esp_config->rx_flow_ctrl_thresh = (impl_cfg->rx_flow_ctrl_thresh > 0) ?
+        impl_cfg->rx_flow_ctrl_thresh : NHAL_ESP32_UART_FLOW_CTRL_THRESH;
+    esp_config->source_clk = (impl_cfg->source_clk != 0) ?
+        (uart_sclk_t)impl_cfg->source_clk : UART_SCLK_DEFAULT;
 
 };
 
+// Unrouted pins (-1, or 0xFF from the uint8_t impl config) are left alone
+static int nhal_uart_pin(uint8_t pin) {
+    return (pin >= GPIO_NUM_MAX) ? UART_PIN_NO_CHANGE : pin;
+}
+
+static esp_err_t nhal_uart_apply_rx_thresholds(uart_port_t port, uint8_t rx_full_thresh, uint8_t rx_timeout) {
+    esp_err_t err = ESP_OK;
+    if (rx_full_thresh > 0) {
+        err = uart_set_rx_full_threshold(port, rx_full_thresh);
+    }
+    if (err == ESP_OK && rx_timeout > 0) {
+        err = uart_set_rx_timeout(port, rx_timeout);
+    }
+    return err;
+}
+
 nhal_result_t nhal_uart_init(struct nhal_uart_context * ctx) {
     if (ctx == NULL) {
         return NHAL_ERR_INVALID_ARG;
@@ -67,6 +94,10 @@ nhal_result_t nhal_uart_init(struct nhal_uart_context * ctx) {
         return NHAL_ERR_OTHER;
     }
 
+    portMUX_INITIALIZE(&ctx->lock);
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
+    ctx->events_claimed = false;
+
     // Context initialized
     ctx->is_initialized = true;
     ctx->is_configured = false;
@@ -101,6 +132,7 @@ nhal_result_t nhal_uart_deinit(struct nhal_uart_context * ctx) {
     ctx->is_initialized = false;
     ctx->is_configured = false;
     ctx->is_driver_installed = false;
+    ctx->event_queue = NULL;
 
     return NHAL_OK;
 }
@@ -124,11 +156,13 @@ nhal_result_t nhal_uart_set_config(struct nhal_uart_context * ctx, struct nhal_u
 
     struct nhal_uart_impl_config *impl_cfg = (struct nhal_uart_impl_config *)cfg->impl_config;
     
+    // The event queue feeds the event-driven receiver (nhal_esp32_uart_rx.h)
+    ctx->event_queue = NULL;
     err = uart_driver_install(ctx->uart_bus_id, 
                              impl_cfg->rx_buffer_size, 
                              impl_cfg->tx_buffer_size, 
                              impl_cfg->queue_size, 
-                             NULL, 
+                             impl_cfg->queue_size > 0 ? &ctx->event_queue : NULL, 
                              impl_cfg->intr_alloc_flags);
     if (err != ESP_OK) {
         return nhal_map_esp_err(err);
@@ -137,13 +171,26 @@ nhal_result_t nhal_uart_set_config(struct nhal_uart_context * ctx, struct nhal_u
     err = uart_set_pin(ctx->uart_bus_id, 
                        impl_cfg->tx_pin_number, 
                        impl_cfg->rx_pin_number, 
-                       UART_PIN_NO_CHANGE, 
-                       UART_PIN_NO_CHANGE);
+                       nhal_uart_pin(impl_cfg->rts_pin_number), 
+                       nhal_uart_pin(impl_cfg->cts_pin_number));
+    if (err == ESP_OK && impl_cfg->uart_mode != UART_MODE_UART) {
+        err = uart_set_mode(ctx->uart_bus_id, (uart_mode_t)impl_cfg->uart_mode);
+    }
+    uint8_t rx_timeout = impl_cfg->rx_timeout;
+    if (rx_timeout == 0 && impl_cfg->uart_mode != UART_MODE_UART && impl_cfg->uart_mode != UART_MODE_IRDA) {
+        rx_timeout = nhal_esp32_uart_rs485_gap_symbols(cfg);
+    }
+    if (err == ESP_OK) {
+        err = nhal_uart_apply_rx_thresholds(ctx->uart_bus_id, impl_cfg->rx_full_thresh, rx_timeout);
+    }
     if (err != ESP_OK) {
         uart_driver_delete(ctx->uart_bus_id);
+        ctx->event_queue = NULL;
         return nhal_map_esp_err(err);
     }
 
+    ctx->tx_buffered = impl_cfg->tx_buffer_size > 0;
+    ctx->uart_mode = (uart_mode_t)impl_cfg->uart_mode;
     ctx->is_configured = true;
     ctx->is_driver_installed = true;
     return NHAL_OK;
@@ -195,3 +242,188 @@ nhal_result_t nhal_uart_read(struct nhal_uart_context * ctx, uint8_t *data, size
         return NHAL_ERR_OTHER;
     }
 }
+
+nhal_result_t nhal_esp32_uart_get_available(struct nhal_uart_context *ctx, size_t *available) {
+    if (ctx == NULL || available == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    return nhal_map_esp_err(uart_get_buffered_data_len(ctx->uart_bus_id, available));
+}
+
+nhal_result_t nhal_esp32_uart_try_write(
+    struct nhal_uart_context *ctx,
+    const uint8_t *data, size_t len,
+    size_t *written
+) {
+    if (ctx == NULL || data == NULL || len == 0 || written == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    // Filling the FIFO directly would overtake bytes still in the ring buffer
+    if (ctx->tx_buffered) {
+        return NHAL_ERR_UNSUPPORTED;
+    }
+
+    int bytes_written = uart_tx_chars(ctx->uart_bus_id, (const char *)data, len);
+    if (bytes_written < 0) {
+        *written = 0;
+        return NHAL_ERR_OTHER;
+    }
+    *written = bytes_written;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_read_up_to(
+    struct nhal_uart_context *ctx,
+    uint8_t *data, size_t len,
+    nhal_timeout_ms timeout_ms,
+    size_t *bytes_read
+) {
+    if (ctx == NULL || data == NULL || len == 0 || bytes_read == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    *bytes_read = 0;
+
+    size_t available = 0;
+    esp_err_t err = uart_get_buffered_data_len(ctx->uart_bus_id, &available);
+    if (err != ESP_OK) {
+        return nhal_map_esp_err(err);
+    }
+
+    if (available == 0) {
+        // Only the first byte is waited for
+        int first = uart_read_bytes(ctx->uart_bus_id, data, 1, pdMS_TO_TICKS(timeout_ms));
+        if (first < 0) {
+            return NHAL_ERR_OTHER;
+        }
+        if (first == 0) {
+            return NHAL_ERR_TIMEOUT;
+        }
+        *bytes_read = 1;
+
+        // The byte is already taken, so report it even if the rest cannot be
+        if (uart_get_buffered_data_len(ctx->uart_bus_id, &available) != ESP_OK) {
+            available = 0;
+        }
+    }
+
+    size_t remaining = len - *bytes_read;
+    if (available > remaining) {
+        available = remaining;
+    }
+    if (available > 0) {
+        int rest = uart_read_bytes(ctx->uart_bus_id, data + *bytes_read, available, 0);
+        if (rest < 0) {
+            return NHAL_ERR_OTHER;
+        }
+        *bytes_read += rest;
+    }
+
+    return NHAL_OK;
+}
+
+void nhal_uart_count_event(struct nhal_uart_context *ctx, uart_event_type_t type) {
+    portENTER_CRITICAL(&ctx->lock);
+    switch (type) {
+        case UART_FIFO_OVF:
+            ctx->stats.fifo_overflows++;
+            break;
+        case UART_BUFFER_FULL:
+            ctx->stats.buffer_full++;
+            break;
+        case UART_FRAME_ERR:
+            ctx->stats.frame_errors++;
+            break;
+        case UART_PARITY_ERR:
+            ctx->stats.parity_errors++;
+            break;
+        case UART_BREAK:
+            ctx->stats.breaks++;
+            break;
+        default:
+            break;
+    }
+    portEXIT_CRITICAL(&ctx->lock);
+}
+
+bool nhal_uart_claim_events(struct nhal_uart_context *ctx) {
+    portENTER_CRITICAL(&ctx->lock);
+    bool claimed = !ctx->events_claimed;
+    ctx->events_claimed = true;
+    portEXIT_CRITICAL(&ctx->lock);
+    return claimed;
+}
+
+void nhal_uart_release_events(struct nhal_uart_context *ctx) {
+    portENTER_CRITICAL(&ctx->lock);
+    ctx->events_claimed = false;
+    portEXIT_CRITICAL(&ctx->lock);
+}
+
+nhal_result_t nhal_esp32_uart_set_rx_thresholds(struct nhal_uart_context *ctx, uint8_t rx_full_thresh, uint8_t rx_timeout) {
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    return nhal_map_esp_err(nhal_uart_apply_rx_thresholds(ctx->uart_bus_id, rx_full_thresh, rx_timeout));
+}
+
+nhal_result_t nhal_esp32_uart_get_stats(struct nhal_uart_context *ctx, struct nhal_uart_stats *stats) {
+    if (ctx == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_copy(&ctx->lock, stats, &ctx->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_reset_stats(struct nhal_uart_context *ctx) {
+    if (ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    nhal_stats_clear(&ctx->lock, &ctx->stats, sizeof(ctx->stats));
+    return NHAL_OK;
+}
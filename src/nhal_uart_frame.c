@@ -0,0 +1,330 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_helpers.h"
+#include "nhal_esp32_uart_frame.h"
+#include "nhal_esp32_uart_internal.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_uart_types.h"
+
+#include "driver/uart.h"
+#include "esp_err.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#include <string.h>
+
+#define NHAL_UART_FRAME_COBS_DELIMITER 0x00
+
+#define NHAL_UART_FRAME_SLIP_END 0xC0
+#define NHAL_UART_FRAME_SLIP_ESC 0xDB
+#define NHAL_UART_FRAME_SLIP_ESC_END 0xDC
+#define NHAL_UART_FRAME_SLIP_ESC_ESC 0xDD
+
+typedef enum {
+    NHAL_UART_FRAME_VALID,
+    NHAL_UART_FRAME_EMPTY,              // Bare delimiter, e.g. a SLIP leading END
+    NHAL_UART_FRAME_DECODE_ERROR,
+    NHAL_UART_FRAME_CRC_ERROR,
+} nhal_uart_frame_status_t;
+
+static bool nhal_uart_frame_cobs_decode(uint8_t *buf, size_t len, size_t *out_len) {
+    size_t r = 0;
+    size_t w = 0;
+    while (r < len) {
+        uint8_t code = buf[r++];
+        size_t run = code - 1;
+        if (code == 0 || run > len - r) {
+            return false;
+        }
+        // The output never overtakes the input
+        memmove(buf + w, buf + r, run);
+        w += run;
+        r += run;
+        if (code != 0xFF && r < len) {
+            buf[w++] = 0;
+        }
+    }
+    *out_len = w;
+    return true;
+}
+
+static bool nhal_uart_frame_slip_decode(uint8_t *buf, size_t len, size_t *out_len) {
+    size_t w = 0;
+    for (size_t r = 0; r < len; r++) {
+        uint8_t c = buf[r];
+        if (c == NHAL_UART_FRAME_SLIP_ESC) {
+            if (++r == len) {
+                return false;
+            }
+            if (buf[r] == NHAL_UART_FRAME_SLIP_ESC_END) {
+                c = NHAL_UART_FRAME_SLIP_END;
+            } else if (buf[r] == NHAL_UART_FRAME_SLIP_ESC_ESC) {
+                c = NHAL_UART_FRAME_SLIP_ESC;
+            } else {
+                return false;
+            }
+        }
+        buf[w++] = c;
+    }
+    *out_len = w;
+    return true;
+}
+
+// Decodes buf[0..len) (delimiter excluded) in place and strips the CRC trailer
+static nhal_uart_frame_status_t nhal_uart_frame_decode(
+    const struct nhal_uart_framer_config *config,
+    uint8_t *buf, size_t len,
+    size_t *payload_len
+) {
+    if (len == 0) {
+        return NHAL_UART_FRAME_EMPTY;
+    }
+
+    size_t decoded = 0;
+    bool ok = (config->encoding == NHAL_UART_FRAME_SLIP) ?
+        nhal_uart_frame_slip_decode(buf, len, &decoded) :
+        nhal_uart_frame_cobs_decode(buf, len, &decoded);
+    if (!ok) {
+        return NHAL_UART_FRAME_DECODE_ERROR;
+    }
+
+    switch (config->crc) {
+        case NHAL_UART_FRAME_CRC16: {
+            if (decoded < 2) {
+                return NHAL_UART_FRAME_DECODE_ERROR;
+            }
+            decoded -= 2;
+            uint16_t expected = (uint16_t)(buf[decoded] | (buf[decoded + 1] << 8));
+            if (esp_rom_crc16_le(0, buf, decoded) != expected) {
+                return NHAL_UART_FRAME_CRC_ERROR;
+            }
+            break;
+        }
+        case NHAL_UART_FRAME_CRC32: {
+            if (decoded < 4) {
+                return NHAL_UART_FRAME_DECODE_ERROR;
+            }
+            decoded -= 4;
+            uint32_t expected = (uint32_t)buf[decoded] |
+                                ((uint32_t)buf[decoded + 1] << 8) |
+                                ((uint32_t)buf[decoded + 2] << 16) |
+                                ((uint32_t)buf[decoded + 3] << 24);
+            if (esp_rom_crc32_le(0, buf, decoded) != expected) {
+                return NHAL_UART_FRAME_CRC_ERROR;
+            }
+            break;
+        }
+        case NHAL_UART_FRAME_CRC_NONE:
+        default:
+            break;
+    }
+
+    *payload_len = decoded;
+    return NHAL_UART_FRAME_VALID;
+}
+
+// Drops everything buffered; the frame in progress has lost its start
+static void nhal_uart_framer_resync(struct nhal_uart_framer *framer) {
+    uart_flush_input(framer->ctx->uart_bus_id);
+    uart_pattern_queue_reset(framer->ctx->uart_bus_id, NHAL_ESP32_UART_FRAME_PATTERN_QUEUE);
+    framer->discard_next = true;
+    portENTER_CRITICAL(&framer->stats_lock);
+    framer->stats.resyncs++;
+    portEXIT_CRITICAL(&framer->stats_lock);
+}
+
+// Reads the frame ending at the delimiter pos bytes ahead and decodes it
+static nhal_uart_frame_status_t nhal_uart_framer_take(struct nhal_uart_framer *framer, size_t pos, size_t *payload_len) {
+    uart_port_t port = framer->ctx->uart_bus_id;
+    size_t frame_len = pos + 1;
+
+    if (frame_len > framer->config.capacity) {
+        while (frame_len > 0) {
+            size_t chunk = (frame_len < framer->config.capacity) ? frame_len : framer->config.capacity;
+            int len = uart_read_bytes(port, framer->config.buffer, chunk, 0);
+            if (len <= 0) {
+                break;
+            }
+            frame_len -= len;
+        }
+        framer->discard_next = false;
+        portENTER_CRITICAL(&framer->stats_lock);
+        framer->stats.oversize++;
+        portEXIT_CRITICAL(&framer->stats_lock);
+        return NHAL_UART_FRAME_EMPTY;
+    }
+
+    int len = uart_read_bytes(port, framer->config.buffer, frame_len, 0);
+    if (len != (int)frame_len) {
+        nhal_uart_framer_resync(framer);
+        return NHAL_UART_FRAME_EMPTY;
+    }
+
+    if (framer->discard_next) {
+        framer->discard_next = false;
+        return NHAL_UART_FRAME_EMPTY;
+    }
+
+    return nhal_uart_frame_decode(&framer->config, framer->config.buffer, pos, payload_len);
+}
+
+nhal_result_t nhal_esp32_uart_framer_start(
+    struct nhal_uart_framer *framer,
+    struct nhal_uart_context *ctx,
+    const struct nhal_uart_framer_config *config
+) {
+    if (framer == NULL || ctx == NULL || config == NULL || config->buffer == NULL || config->capacity < 2) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured || ctx->event_queue == NULL) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    if (framer->is_running || !nhal_uart_claim_events(ctx)) {
+        return NHAL_ERR_BUSY;
+    }
+
+    memset(framer, 0, sizeof(*framer));
+    portMUX_INITIALIZE(&framer->stats_lock);
+    framer->ctx = ctx;
+    framer->config = *config;
+
+    char delimiter = (config->encoding == NHAL_UART_FRAME_SLIP) ?
+        NHAL_UART_FRAME_SLIP_END : NHAL_UART_FRAME_COBS_DELIMITER;
+    esp_err_t ret_err = uart_enable_pattern_det_baud_intr(
+        ctx->uart_bus_id, delimiter, 1,
+        NHAL_ESP32_UART_FRAME_CHR_TOUT,
+        NHAL_ESP32_UART_FRAME_POST_IDLE,
+        NHAL_ESP32_UART_FRAME_PRE_IDLE
+    );
+    if (ret_err == ESP_OK) {
+        ret_err = uart_pattern_queue_reset(ctx->uart_bus_id, NHAL_ESP32_UART_FRAME_PATTERN_QUEUE);
+    }
+    if (ret_err != ESP_OK) {
+        uart_disable_pattern_det_intr(ctx->uart_bus_id);
+        nhal_uart_release_events(ctx);
+        return nhal_map_esp_err(ret_err);
+    }
+
+    // Start from a clean line; the first delimiter only ends what came before
+    uart_flush_input(ctx->uart_bus_id);
+    xQueueReset(ctx->event_queue);
+    framer->discard_next = true;
+
+    framer->is_running = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_framer_stop(struct nhal_uart_framer *framer) {
+    if (framer == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!framer->is_running) {
+        return NHAL_OK;
+    }
+
+    uart_disable_pattern_det_intr(framer->ctx->uart_bus_id);
+    nhal_uart_release_events(framer->ctx);
+    framer->is_running = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_framer_receive(
+    struct nhal_uart_framer *framer,
+    nhal_timeout_ms timeout_ms,
+    const uint8_t **payload, size_t *len
+) {
+    if (framer == NULL || payload == NULL || len == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!framer->is_running) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    struct nhal_uart_context *ctx = framer->ctx;
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+
+    for (;;) {
+        // Delimiters already recorded are handled before waiting for more
+        int pos = uart_pattern_pop_pos(ctx->uart_bus_id);
+        if (pos >= 0) {
+            int64_t start_us = esp_timer_get_time();
+            size_t payload_len = 0;
+            nhal_uart_frame_status_t status = nhal_uart_framer_take(framer, (size_t)pos, &payload_len);
+            int64_t end_us = esp_timer_get_time();
+
+            portENTER_CRITICAL(&framer->stats_lock);
+            framer->stats.cpu_time_us += end_us - start_us;
+            switch (status) {
+                case NHAL_UART_FRAME_VALID:
+                    if (framer->stats.frames == 0) {
+                        framer->stats.first_frame_us = end_us;
+                    }
+                    framer->stats.last_frame_us = end_us;
+                    framer->stats.frames++;
+                    framer->stats.bytes += payload_len;
+                    break;
+                case NHAL_UART_FRAME_DECODE_ERROR:
+                    framer->stats.decode_errors++;
+                    break;
+                case NHAL_UART_FRAME_CRC_ERROR:
+                    framer->stats.crc_errors++;
+                    break;
+                case NHAL_UART_FRAME_EMPTY:
+                default:
+                    break;
+            }
+            portEXIT_CRITICAL(&framer->stats_lock);
+
+            if (status == NHAL_UART_FRAME_VALID) {
+                *payload = framer->config.buffer;
+                *len = payload_len;
+                return NHAL_OK;
+            }
+            continue;
+        }
+
+        int64_t remaining_us = deadline_us - esp_timer_get_time();
+        if (remaining_us < 0) {
+            remaining_us = 0;
+        }
+
+        uart_event_t event;
+        if (xQueueReceive(ctx->event_queue, &event, pdMS_TO_TICKS((remaining_us + 999) / 1000)) != pdTRUE) {
+            return NHAL_ERR_TIMEOUT;
+        }
+
+        nhal_uart_count_event(ctx, event.type);
+        if (event.type == UART_FIFO_OVF || event.type == UART_BUFFER_FULL) {
+            nhal_uart_framer_resync(framer);
+        }
+    }
+}
+
+nhal_result_t nhal_esp32_uart_framer_get_stats(struct nhal_uart_framer *framer, struct nhal_uart_framer_stats *stats) {
+    if (framer == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&framer->stats_lock, stats, &framer->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_framer_reset_stats(struct nhal_uart_framer *framer) {
+    if (framer == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&framer->stats_lock, &framer->stats, sizeof(framer->stats));
+    return NHAL_OK;
+}
@@ -0,0 +1,387 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_uart_log.h"
+#include "nhal_esp32_worker.h"
+
+#include "nhal_common.h"
+#include "nhal_uart_types.h"
+
+#include "driver/uart.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define NHAL_UART_LOG_RECORD_SIZE(len) \
+    ((uint32_t)((sizeof(struct nhal_uart_log_header) + (len) + 7u) & ~(size_t)7u))
+
+static inline struct nhal_uart_log_header *nhal_uart_log_header_at(struct nhal_uart_log *log, uint32_t position) {
+    return (struct nhal_uart_log_header *)(log->config.storage + (position & log->mask));
+}
+
+static inline uint32_t *nhal_uart_log_commit_at(struct nhal_uart_log *log, uint32_t position) {
+    return &log->config.commits[(position & log->mask) / 8];
+}
+
+static inline bool nhal_uart_log_is_committed(struct nhal_uart_log *log, uint32_t position) {
+    return __atomic_load_n(nhal_uart_log_commit_at(log, position), __ATOMIC_ACQUIRE) == position;
+}
+
+// Called by whoever freed the record at position. Clears only that record's
+// own marker: once tail has moved on, the slot may already be reserved and
+// committed again at a later position, which must survive.
+static inline void nhal_uart_log_uncommit(struct nhal_uart_log *log, uint32_t position) {
+    uint32_t expected = position;
+    __atomic_compare_exchange_n(nhal_uart_log_commit_at(log, position), &expected,
+                                NHAL_UART_LOG_UNCOMMITTED, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+// Frees the oldest record if it is committed. Returns false only when it is
+// not, so the caller cannot make room; a lost race just means "try again".
+static bool IRAM_ATTR nhal_uart_log_drop_oldest(struct nhal_uart_log *log, uint32_t tail) {
+    if (!nhal_uart_log_is_committed(log, tail)) {
+        return false;
+    }
+
+    // Only valid if tail has not moved, which the exchange checks
+    struct nhal_uart_log_header *header = nhal_uart_log_header_at(log, tail);
+    uint32_t size = header->size;
+    uint16_t len = header->len;
+    uint32_t position = tail;
+    if (__atomic_compare_exchange_n(&log->tail, &tail, tail + size, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        nhal_uart_log_uncommit(log, position);
+        if (len > 0) {
+            __atomic_fetch_add(&log->stats.dropped_oldest, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return true;
+}
+
+// Drop-newest only: the drain alone frees space, so records cannot change
+// under it. Gathers the run of committed payloads from tail, wrap padding
+// included, frees it and hands it to the driver in one write.
+static void nhal_uart_log_drain_batch(struct nhal_uart_log *log, uint32_t tail, uint32_t head) {
+    uint32_t end = tail;
+    size_t batched = 0;
+    uint32_t records = 0;
+
+    while (end != head && nhal_uart_log_is_committed(log, end)) {
+        struct nhal_uart_log_header *header = nhal_uart_log_header_at(log, end);
+        if (batched + header->len > sizeof(log->chunk)) {
+            break;
+        }
+        memcpy(&log->chunk[batched], header + 1, header->len);
+        batched += header->len;
+        records += (header->len > 0);
+        nhal_uart_log_uncommit(log, end);
+        end += header->size;
+    }
+    __atomic_store_n(&log->tail, end, __ATOMIC_RELEASE);
+
+    if (batched > 0) {
+        uart_write_bytes(log->ctx->uart_bus_id, (const char *)log->chunk, batched);
+        portENTER_CRITICAL(&log->stats_lock);
+        log->stats.drained += records;
+        log->stats.drained_bytes += batched;
+        portEXIT_CRITICAL(&log->stats_lock);
+    }
+}
+
+static void nhal_uart_log_drain(struct nhal_uart_log *log) {
+    for (;;) {
+        uint32_t tail = __atomic_load_n(&log->tail, __ATOMIC_ACQUIRE);
+        uint32_t head = __atomic_load_n(&log->head, __ATOMIC_ACQUIRE);
+        if (tail == head) {
+            return;
+        }
+        portENTER_CRITICAL(&log->stats_lock);
+        if (head - tail > log->stats.max_pending) {
+            log->stats.max_pending = head - tail;
+        }
+        portEXIT_CRITICAL(&log->stats_lock);
+
+        if (!nhal_uart_log_is_committed(log, tail)) {
+            return; // Oldest record not committed yet
+        }
+
+        if (log->config.policy == NHAL_UART_LOG_DROP_NEWEST) {
+            nhal_uart_log_drain_batch(log, tail, head);
+            continue;
+        }
+
+        // Producers may drop the record while it is copied; the copy only
+        // counts if tail is still on it afterwards
+        struct nhal_uart_log_header *header = nhal_uart_log_header_at(log, tail);
+        uint32_t size = header->size;
+        uint16_t len = header->len;
+        if (len > log->max_len) {
+            continue; // Header already overwritten, so tail has moved
+        }
+        memcpy(log->chunk, header + 1, len);
+        uint32_t position = tail;
+        if (!__atomic_compare_exchange_n(&log->tail, &tail, tail + size, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            portENTER_CRITICAL(&log->stats_lock);
+            log->stats.torn++;
+            portEXIT_CRITICAL(&log->stats_lock);
+            continue;
+        }
+        nhal_uart_log_uncommit(log, position);
+
+        if (len > 0) {
+            uart_write_bytes(log->ctx->uart_bus_id, (const char *)log->chunk, len);
+            portENTER_CRITICAL(&log->stats_lock);
+            log->stats.drained++;
+            log->stats.drained_bytes += len;
+            portEXIT_CRITICAL(&log->stats_lock);
+        }
+    }
+}
+
+static void nhal_uart_log_task(void *arg) {
+    struct nhal_uart_log *log = (struct nhal_uart_log *)arg;
+
+    while (!log->stopping) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(NHAL_ESP32_UART_LOG_DRAIN_PERIOD_MS));
+        nhal_uart_log_drain(log);
+    }
+    nhal_uart_log_drain(log);
+
+    nhal_worker_exit(&log->gate);
+}
+
+nhal_result_t nhal_esp32_uart_log_start(
+    struct nhal_uart_log *log,
+    struct nhal_uart_context *ctx,
+    const struct nhal_uart_log_config *config
+) {
+    if (log == NULL || ctx == NULL || config == NULL || config->storage == NULL || config->commits == NULL ||
+        ((uintptr_t)config->storage & 7u) != 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    size_t storage_size = config->storage_size;
+    if (storage_size < 64 || (storage_size & (storage_size - 1)) != 0 || storage_size > UINT32_MAX / 2) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    if (log->is_running) {
+        return NHAL_ERR_BUSY;
+    }
+
+    memset(log, 0, sizeof(*log));
+    portMUX_INITIALIZE(&log->stats_lock);
+    log->ctx = ctx;
+    log->config = *config;
+    log->mask = (uint32_t)storage_size - 1;
+
+    // Half the ring guarantees a record fits even after wrap padding
+    log->max_len = storage_size / 2 - sizeof(struct nhal_uart_log_header);
+    if (log->max_len > NHAL_ESP32_UART_LOG_MAX_RECORD) {
+        log->max_len = NHAL_ESP32_UART_LOG_MAX_RECORD;
+    }
+
+    // No position is committed until a producer writes its own there
+    for (size_t i = 0; i < NHAL_ESP32_UART_LOG_COMMITS(storage_size); i++) {
+        config->commits[i] = NHAL_UART_LOG_UNCOMMITTED;
+    }
+
+    nhal_worker_gate_init(&log->gate);
+
+    log->task = xTaskCreateStatic(
+        nhal_uart_log_task,
+        "nhal_uart_log",
+        NHAL_ESP32_UART_LOG_TASK_STACK_SIZE,
+        log,
+        NHAL_ESP32_UART_LOG_TASK_PRIORITY,
+        log->task_stack,
+        &log->task_struct
+    );
+    if (log->task == NULL) {
+        return NHAL_ERR_OTHER;
+    }
+
+    log->is_running = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_log_stop(struct nhal_uart_log *log) {
+    if (log == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!log->is_running) {
+        return NHAL_OK;
+    }
+
+    __atomic_store_n(&log->is_running, false, __ATOMIC_SEQ_CST);
+
+    // Producers already past the check may still be writing the ring; the
+    // final drain must see their records and the caller may free the storage
+    while (__atomic_load_n(&log->producers, __ATOMIC_SEQ_CST) != 0) {
+        vTaskDelay(1);
+    }
+
+    log->stopping = true;
+    xTaskNotifyGive(log->task);
+    nhal_worker_wait_stopped(&log->gate, log->task);
+    log->task = NULL;
+    return NHAL_OK;
+}
+
+nhal_result_t IRAM_ATTR nhal_esp32_uart_log_reserve(
+    struct nhal_uart_log *log,
+    size_t len,
+    struct nhal_uart_log_reservation *reservation
+) {
+    if (log == NULL || reservation == NULL || len == 0 || len > log->max_len) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    // Counted in before the check, so stop either sees this producer or
+    // this producer sees the sink stopped
+    __atomic_fetch_add(&log->producers, 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&log->is_running, __ATOMIC_SEQ_CST)) {
+        __atomic_fetch_sub(&log->producers, 1, __ATOMIC_RELEASE);
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    uint32_t capacity = log->mask + 1;
+    uint32_t size = NHAL_UART_LOG_RECORD_SIZE(len);
+    uint32_t head;
+    uint32_t pad;
+
+    for (;;) {
+        // tail first: a head read later can never be behind it
+        uint32_t tail = __atomic_load_n(&log->tail, __ATOMIC_ACQUIRE);
+        head = __atomic_load_n(&log->head, __ATOMIC_RELAXED);
+
+        // A record never wraps; the end of the ring becomes padding instead
+        uint32_t contiguous = capacity - (head & log->mask);
+        pad = (size > contiguous) ? contiguous : 0;
+
+        if (head + pad + size - tail <= capacity) {
+            if (__atomic_compare_exchange_n(&log->head, &head, head + pad + size, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+                break;
+            }
+            continue;
+        }
+
+        if (log->config.policy == NHAL_UART_LOG_DROP_OLDEST && nhal_uart_log_drop_oldest(log, tail)) {
+            continue;
+        }
+
+        __atomic_fetch_add(&log->stats.dropped_newest, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&log->producers, 1, __ATOMIC_RELEASE);
+        return NHAL_ERR_BUSY;
+    }
+
+    if (pad > 0) {
+        struct nhal_uart_log_header *padding = nhal_uart_log_header_at(log, head);
+        padding->size = (uint16_t)pad;
+        padding->len = 0;
+        __atomic_store_n(nhal_uart_log_commit_at(log, head), head, __ATOMIC_RELEASE);
+        head += pad;
+    }
+
+    struct nhal_uart_log_header *header = nhal_uart_log_header_at(log, head);
+    header->size = (uint16_t)size;
+    header->len = (uint16_t)len;
+
+    reservation->data = (uint8_t *)(header + 1);
+    reservation->len = len;
+    reservation->position = head;
+    return NHAL_OK;
+}
+
+nhal_result_t IRAM_ATTR nhal_esp32_uart_log_commit(
+    struct nhal_uart_log *log,
+    const struct nhal_uart_log_reservation *reservation,
+    size_t len
+) {
+    if (log == NULL || reservation == NULL || len > reservation->len) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_uart_log_header *header = nhal_uart_log_header_at(log, reservation->position);
+    header->len = (uint16_t)len;
+    __atomic_store_n(nhal_uart_log_commit_at(log, reservation->position), reservation->position, __ATOMIC_RELEASE);
+
+    if (len > 0) {
+        __atomic_fetch_add(&log->stats.records, 1, __ATOMIC_RELAXED);
+    }
+
+    // Last touch of the ring: stop may return once every producer is out
+    __atomic_fetch_sub(&log->producers, 1, __ATOMIC_RELEASE);
+    return NHAL_OK;
+}
+
+nhal_result_t IRAM_ATTR nhal_esp32_uart_log_write(struct nhal_uart_log *log, const uint8_t *data, size_t len) {
+    if (data == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_uart_log_reservation reservation;
+    nhal_result_t result = nhal_esp32_uart_log_reserve(log, len, &reservation);
+    if (result != NHAL_OK) {
+        return result;
+    }
+
+    memcpy(reservation.data, data, len);
+    return nhal_esp32_uart_log_commit(log, &reservation, len);
+}
+
+nhal_result_t nhal_esp32_uart_log_flush(struct nhal_uart_log *log) {
+    if (log == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!log->is_running) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    xTaskNotifyGive(log->task);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_log_get_stats(struct nhal_uart_log *log, struct nhal_uart_log_stats *stats) {
+    if (log == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&log->stats_lock);
+    *stats = log->stats;
+    stats->records = __atomic_load_n(&log->stats.records, __ATOMIC_RELAXED);
+    stats->dropped_newest = __atomic_load_n(&log->stats.dropped_newest, __ATOMIC_RELAXED);
+    stats->dropped_oldest = __atomic_load_n(&log->stats.dropped_oldest, __ATOMIC_RELAXED);
+    portEXIT_CRITICAL(&log->stats_lock);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_log_reset_stats(struct nhal_uart_log *log) {
+    if (log == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    // Producers never take the lock, so their counters may tick between
+    // the stores
+    portENTER_CRITICAL(&log->stats_lock);
+    __atomic_store_n(&log->stats.records, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&log->stats.dropped_newest, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&log->stats.dropped_oldest, 0, __ATOMIC_RELAXED);
+    log->stats.drained = 0;
+    log->stats.drained_bytes = 0;
+    log->stats.torn = 0;
+    log->stats.max_pending = 0;
+    portEXIT_CRITICAL(&log->stats_lock);
+    return NHAL_OK;
+}
@@ -0,0 +1,136 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_uart.h"
+#include "nhal_esp32_uart_reader.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_uart_types.h"
+
+#include "esp_timer.h"
+
+#include <string.h>
+
+// Reads whatever the driver has into the free tail, waiting up to timeout_ms
+// for the first byte. want is the total the caller is filling towards.
+static nhal_result_t nhal_uart_reader_fill(struct nhal_uart_reader *reader, size_t want, nhal_timeout_ms timeout_ms) {
+    size_t buffered = reader->end - reader->start;
+
+    if (reader->start > 0 && reader->capacity - reader->end < want - buffered) {
+        memmove(reader->buffer, reader->buffer + reader->start, buffered);
+        reader->start = 0;
+        reader->end = buffered;
+        portENTER_CRITICAL(&reader->stats_lock);
+        reader->stats.compactions++;
+        reader->stats.bytes_moved += buffered;
+        portEXIT_CRITICAL(&reader->stats_lock);
+    }
+
+    size_t bytes_read = 0;
+    nhal_result_t result = nhal_esp32_uart_read_up_to(
+        reader->ctx,
+        reader->buffer + reader->end, reader->capacity - reader->end,
+        timeout_ms,
+        &bytes_read
+    );
+    if (bytes_read > 0) {
+        reader->end += bytes_read;
+        portENTER_CRITICAL(&reader->stats_lock);
+        reader->stats.fills++;
+        reader->stats.bytes += bytes_read;
+        portEXIT_CRITICAL(&reader->stats_lock);
+    }
+    return result;
+}
+
+nhal_result_t nhal_esp32_uart_reader_init(
+    struct nhal_uart_reader *reader,
+    struct nhal_uart_context *ctx,
+    uint8_t *buffer, size_t capacity
+) {
+    if (reader == NULL || ctx == NULL || buffer == NULL || capacity == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    memset(reader, 0, sizeof(*reader));
+    portMUX_INITIALIZE(&reader->stats_lock);
+    reader->ctx = ctx;
+    reader->buffer = buffer;
+    reader->capacity = capacity;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_reader_peek(
+    struct nhal_uart_reader *reader,
+    size_t min_len,
+    nhal_timeout_ms timeout_ms,
+    const uint8_t **data, size_t *len
+) {
+    if (reader == NULL || data == NULL || len == NULL || min_len > reader->capacity) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&reader->stats_lock);
+    reader->stats.peeks++;
+    portEXIT_CRITICAL(&reader->stats_lock);
+
+    size_t want = (min_len > 0) ? min_len : 1;
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    nhal_result_t result = NHAL_OK;
+
+    while (reader->end - reader->start < want) {
+        int64_t remaining_us = deadline_us - esp_timer_get_time();
+        if (remaining_us < 0) {
+            remaining_us = 0;
+        }
+
+        // After the deadline this still takes bytes that are already buffered
+        result = nhal_uart_reader_fill(reader, want, (nhal_timeout_ms)((remaining_us + 999) / 1000));
+        if (result != NHAL_OK) {
+            break;
+        }
+    }
+
+    *data = reader->buffer + reader->start;
+    *len = reader->end - reader->start;
+
+    if (min_len == 0 && result == NHAL_ERR_TIMEOUT) {
+        return NHAL_OK;
+    }
+    return result;
+}
+
+nhal_result_t nhal_esp32_uart_reader_consume(struct nhal_uart_reader *reader, size_t len) {
+    if (reader == NULL || len > reader->end - reader->start) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    reader->start += len;
+    portENTER_CRITICAL(&reader->stats_lock);
+    reader->stats.consumed += len;
+    portEXIT_CRITICAL(&reader->stats_lock);
+
+    // Empty: the next fill starts at the front without moving anything
+    if (reader->start == reader->end) {
+        reader->start = 0;
+        reader->end = 0;
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_reader_get_stats(struct nhal_uart_reader *reader, struct nhal_uart_reader_stats *stats) {
+    if (reader == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&reader->stats_lock, stats, &reader->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_reader_reset_stats(struct nhal_uart_reader *reader) {
+    if (reader == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&reader->stats_lock, &reader->stats, sizeof(reader->stats));
+    return NHAL_OK;
+}
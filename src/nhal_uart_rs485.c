@@ -0,0 +1,263 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_helpers.h"
+#include "nhal_esp32_uart_internal.h"
+#include "nhal_esp32_uart_rs485.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_uart_types.h"
+
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#include <string.h>
+
+// Modbus RTU fixes the gap at 1750 us above 19200 baud
+#define NHAL_UART_RS485_FIXED_GAP_BAUD 19200
+#define NHAL_UART_RS485_FIXED_GAP_US 1750
+
+// The RX timeout register holds at most this many symbols
+#define NHAL_UART_RS485_MAX_GAP_SYMBOLS 126
+
+uint8_t nhal_esp32_uart_rs485_gap_symbols(const struct nhal_uart_config *cfg) {
+    if (cfg == NULL || cfg->baudrate <= NHAL_UART_RS485_FIXED_GAP_BAUD) {
+        return 3; // 3.5 characters
+    }
+
+    uint32_t bits = 1; // Start bit
+    bits += (cfg->data_bits == NHAL_UART_DATA_BITS_7) ? 7 : 8;
+    bits += (cfg->parity == NHAL_UART_PARITY_NONE) ? 0 : 1;
+    bits += (cfg->stop_bits == NHAL_UART_STOP_BITS_2) ? 2 : 1;
+
+    uint64_t symbols = (uint64_t)NHAL_UART_RS485_FIXED_GAP_US * cfg->baudrate / (1000000ull * bits);
+    if (symbols < 2) {
+        return 2;
+    }
+    if (symbols > NHAL_UART_RS485_MAX_GAP_SYMBOLS) {
+        return NHAL_UART_RS485_MAX_GAP_SYMBOLS;
+    }
+    return (uint8_t)symbols;
+}
+
+// Drops all buffered input together with the queued events that describe
+// it, which would otherwise be counted into the next frame
+static void nhal_uart_rs485_flush(struct nhal_uart_context *ctx) {
+    uart_flush_input(ctx->uart_bus_id);
+    xQueueReset(ctx->event_queue);
+}
+
+// Reads and drops n buffered bytes through the caller's buffer
+static void nhal_uart_rs485_skip(uart_port_t port, uint8_t *buffer, size_t capacity, size_t n) {
+    while (n > 0) {
+        size_t chunk = (n < capacity) ? n : capacity;
+        int len = uart_read_bytes(port, buffer, chunk, 0);
+        if (len <= 0) {
+            break;
+        }
+        n -= len;
+    }
+}
+
+nhal_result_t nhal_esp32_uart_rs485_start(struct nhal_uart_rs485 *link, struct nhal_uart_context *ctx) {
+    if (link == NULL || ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured || ctx->event_queue == NULL) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    // The driver reports collisions only in these modes; send relies on it
+    if (ctx->uart_mode != UART_MODE_RS485_HALF_DUPLEX && ctx->uart_mode != UART_MODE_RS485_COLLISION_DETECT) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    if (link->is_running || !nhal_uart_claim_events(ctx)) {
+        return NHAL_ERR_BUSY;
+    }
+
+    memset(link, 0, sizeof(*link));
+    portMUX_INITIALIZE(&link->stats_lock);
+    link->ctx = ctx;
+
+    // Start between frames: whatever is buffered has no known start
+    nhal_uart_rs485_flush(ctx);
+
+    link->is_running = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_rs485_stop(struct nhal_uart_rs485 *link) {
+    if (link == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!link->is_running) {
+        return NHAL_OK;
+    }
+
+    nhal_uart_release_events(link->ctx);
+    link->is_running = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_rs485_receive(
+    struct nhal_uart_rs485 *link,
+    uint8_t *data, size_t capacity,
+    size_t *len,
+    nhal_timeout_ms timeout_ms
+) {
+    if (link == NULL || data == NULL || capacity == 0 || len == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!link->is_running) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    struct nhal_uart_context *ctx = link->ctx;
+    uint64_t deadline_us = nhal_get_timestamp_microseconds() + (uint64_t)timeout_ms * 1000;
+
+    for (;;) {
+        uint64_t now_us = nhal_get_timestamp_microseconds();
+        uint64_t remaining_us = (deadline_us > now_us) ? deadline_us - now_us : 0;
+
+        uart_event_t event;
+        if (xQueueReceive(ctx->event_queue, &event, pdMS_TO_TICKS((remaining_us + 999) / 1000)) != pdTRUE) {
+            return NHAL_ERR_TIMEOUT;
+        }
+
+        nhal_uart_count_event(ctx, event.type);
+        if (event.type == UART_FIFO_OVF || event.type == UART_BUFFER_FULL) {
+            // Bytes were lost somewhere in the frame; drop it and wait for a gap
+            nhal_uart_rs485_flush(ctx);
+            link->pending = 0;
+            link->discarding = true;
+            continue;
+        }
+        if (event.type != UART_DATA) {
+            continue;
+        }
+
+        // The driver raises a timeout-flagged data event once the line has
+        // been idle for the gap, so it carries the last bytes of a frame
+        link->pending += event.size;
+        if (!event.timeout_flag) {
+            continue;
+        }
+
+        uint64_t rx_end_us = nhal_get_timestamp_microseconds();
+        size_t frame_len = link->pending;
+        bool discarding = link->discarding;
+        link->pending = 0;
+        link->discarding = false;
+
+        if (discarding) {
+            nhal_uart_rs485_skip(ctx->uart_bus_id, data, capacity, frame_len);
+            continue;
+        }
+        if (frame_len > capacity) {
+            nhal_uart_rs485_skip(ctx->uart_bus_id, data, capacity, frame_len);
+            portENTER_CRITICAL(&link->stats_lock);
+            link->stats.overruns++;
+            portEXIT_CRITICAL(&link->stats_lock);
+            continue;
+        }
+
+        int read = uart_read_bytes(ctx->uart_bus_id, data, frame_len, 0);
+        if (read != (int)frame_len) {
+            // The events no longer match the buffer; start over at the next gap
+            nhal_uart_rs485_flush(ctx);
+            link->discarding = true;
+            continue;
+        }
+
+        portENTER_CRITICAL(&link->stats_lock);
+        link->stats.frames_received++;
+        link->stats.last_rx_end_us = rx_end_us;
+        portEXIT_CRITICAL(&link->stats_lock);
+        link->rx_end_us = rx_end_us;
+        link->replying = true;
+        *len = frame_len;
+        return NHAL_OK;
+    }
+}
+
+nhal_result_t nhal_esp32_uart_rs485_send(struct nhal_uart_rs485 *link, const uint8_t *data, size_t len) {
+    if (link == NULL || data == NULL || len == 0) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!link->is_running) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    uart_port_t port = link->ctx->uart_bus_id;
+    uint64_t tx_start_us = nhal_get_timestamp_microseconds();
+
+    portENTER_CRITICAL(&link->stats_lock);
+    if (link->replying) {
+        uint32_t turnaround_us = (uint32_t)(tx_start_us - link->rx_end_us);
+        link->replying = false;
+        link->stats.last_turnaround_us = turnaround_us;
+        if (turnaround_us > link->stats.max_turnaround_us) {
+            link->stats.max_turnaround_us = turnaround_us;
+        }
+        link->stats.turnaround_total_us += turnaround_us;
+        link->stats.turnarounds++;
+    }
+    link->stats.last_tx_start_us = tx_start_us;
+    portEXIT_CRITICAL(&link->stats_lock);
+
+    int written = uart_write_bytes(port, (const char *)data, len);
+    if (written != (int)len) {
+        return NHAL_ERR_OTHER;
+    }
+
+    // DE drops with the last stop bit, so drained means the bus is free again
+    esp_err_t ret_err = uart_wait_tx_done(port, pdMS_TO_TICKS(link->ctx->timeout_ms));
+    if (ret_err != ESP_OK) {
+        return nhal_map_esp_err(ret_err);
+    }
+    uint64_t tx_done_us = nhal_get_timestamp_microseconds();
+    portENTER_CRITICAL(&link->stats_lock);
+    link->stats.last_tx_done_us = tx_done_us;
+    portEXIT_CRITICAL(&link->stats_lock);
+
+    bool collision = false;
+    ret_err = uart_get_collision_flag(port, &collision);
+    if (ret_err != ESP_OK) {
+        return nhal_map_esp_err(ret_err);
+    }
+    portENTER_CRITICAL(&link->stats_lock);
+    if (collision) {
+        link->stats.collisions++;
+    } else {
+        link->stats.frames_sent++;
+    }
+    portEXIT_CRITICAL(&link->stats_lock);
+    return collision ? NHAL_ERR_OTHER : NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_rs485_get_stats(struct nhal_uart_rs485 *link, struct nhal_uart_rs485_stats *stats) {
+    if (link == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&link->stats_lock, stats, &link->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_rs485_reset_stats(struct nhal_uart_rs485 *link) {
+    if (link == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&link->stats_lock, &link->stats, sizeof(link->stats));
+    return NHAL_OK;
+}
@@ -0,0 +1,189 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_uart_internal.h"
+#include "nhal_esp32_uart_rx.h"
+#include "nhal_esp32_worker.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_uart_types.h"
+
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "freertos/stream_buffer.h"
+
+#include <string.h>
+
+// Event type the driver never posts; tells the receiver task to exit
+#define NHAL_UART_RX_STOP_EVENT UART_EVENT_MAX
+
+static void nhal_uart_rx_report(struct nhal_uart_rx *rx, nhal_uart_rx_event_t event) {
+    if (rx->config.on_event != NULL) {
+        rx->config.on_event(rx->ctx, event, rx->config.user_data);
+    }
+}
+
+// Reads everything buffered so far, not just the bytes of the event
+static void nhal_uart_rx_drain(struct nhal_uart_rx *rx) {
+    for (;;) {
+        int len = uart_read_bytes(rx->ctx->uart_bus_id, rx->chunk, sizeof(rx->chunk), 0);
+        if (len <= 0) {
+            break;
+        }
+
+        size_t dropped = 0;
+        if (rx->config.stream != NULL) {
+            dropped = len - xStreamBufferSend(rx->config.stream, rx->chunk, len, 0);
+        }
+        if (rx->config.on_data != NULL) {
+            rx->config.on_data(rx->ctx, rx->chunk, len, rx->config.user_data);
+        }
+
+        portENTER_CRITICAL(&rx->lock);
+        rx->stats.chunks++;
+        rx->stats.bytes += len;
+        rx->stats.stream_dropped += dropped;
+        portEXIT_CRITICAL(&rx->lock);
+
+        if ((size_t)len < sizeof(rx->chunk)) {
+            break;
+        }
+    }
+}
+
+static void nhal_uart_rx_task(void *arg) {
+    struct nhal_uart_rx *rx = (struct nhal_uart_rx *)arg;
+    uart_event_t event;
+
+    for (;;) {
+        if (xQueueReceive(rx->ctx->event_queue, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (event.type == NHAL_UART_RX_STOP_EVENT) {
+            break;
+        }
+
+        nhal_uart_count_event(rx->ctx, event.type);
+
+        switch (event.type) {
+            case UART_DATA:
+                portENTER_CRITICAL(&rx->lock);
+                rx->stats.data_events++;
+                portEXIT_CRITICAL(&rx->lock);
+                nhal_uart_rx_drain(rx);
+                break;
+            case UART_FIFO_OVF:
+                // Bytes were lost: drop the rest of the damaged stream too
+                uart_flush_input(rx->ctx->uart_bus_id);
+                nhal_uart_rx_report(rx, NHAL_UART_RX_EVENT_FIFO_OVERFLOW);
+                break;
+            case UART_BUFFER_FULL:
+                uart_flush_input(rx->ctx->uart_bus_id);
+                nhal_uart_rx_report(rx, NHAL_UART_RX_EVENT_BUFFER_FULL);
+                break;
+            case UART_BREAK:
+                nhal_uart_rx_report(rx, NHAL_UART_RX_EVENT_BREAK);
+                break;
+            case UART_FRAME_ERR:
+                nhal_uart_rx_report(rx, NHAL_UART_RX_EVENT_FRAME_ERROR);
+                break;
+            case UART_PARITY_ERR:
+                nhal_uart_rx_report(rx, NHAL_UART_RX_EVENT_PARITY_ERROR);
+                break;
+            case UART_PATTERN_DET:
+                portENTER_CRITICAL(&rx->lock);
+                rx->stats.patterns++;
+                portEXIT_CRITICAL(&rx->lock);
+                nhal_uart_rx_report(rx, NHAL_UART_RX_EVENT_PATTERN);
+                nhal_uart_rx_drain(rx);
+                break;
+            default:
+                break;
+        }
+    }
+
+    nhal_worker_exit(&rx->gate);
+}
+
+nhal_result_t nhal_esp32_uart_rx_start(
+    struct nhal_uart_rx *rx,
+    struct nhal_uart_context *ctx,
+    const struct nhal_uart_rx_config *config
+) {
+    if (rx == NULL || ctx == NULL || config == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured || ctx->event_queue == NULL) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    if (rx->is_running || !nhal_uart_claim_events(ctx)) {
+        return NHAL_ERR_BUSY;
+    }
+
+    memset(rx, 0, sizeof(*rx));
+    rx->ctx = ctx;
+    rx->config = *config;
+    portMUX_INITIALIZE(&rx->lock);
+    nhal_worker_gate_init(&rx->gate);
+
+    rx->task = xTaskCreateStatic(
+        nhal_uart_rx_task,
+        "nhal_uart_rx",
+        NHAL_ESP32_UART_RX_TASK_STACK_SIZE,
+        rx,
+        NHAL_ESP32_UART_RX_TASK_PRIORITY,
+        rx->task_stack,
+        &rx->task_struct
+    );
+    if (rx->task == NULL) {
+        nhal_uart_release_events(ctx);
+        return NHAL_ERR_OTHER;
+    }
+
+    rx->is_running = true;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_rx_stop(struct nhal_uart_rx *rx) {
+    if (rx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!rx->is_running) {
+        return NHAL_OK;
+    }
+
+    uart_event_t stop_event = { .type = NHAL_UART_RX_STOP_EVENT };
+    xQueueSend(rx->ctx->event_queue, &stop_event, portMAX_DELAY);
+    nhal_worker_wait_stopped(&rx->gate, rx->task);
+    rx->task = NULL;
+
+    nhal_uart_release_events(rx->ctx);
+    rx->is_running = false;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_rx_get_stats(struct nhal_uart_rx *rx, struct nhal_uart_rx_stats *stats) {
+    if (rx == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&rx->lock, stats, &rx->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_rx_reset_stats(struct nhal_uart_rx *rx) {
+    if (rx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&rx->lock, &rx->stats, sizeof(rx->stats));
+    return NHAL_OK;
+}
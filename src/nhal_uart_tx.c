@@ -0,0 +1,276 @@
+#include "nhal_esp32_defs.h"
+#include "nhal_esp32_helpers.h"
+#include "nhal_esp32_uart_tx.h"
+#include "nhal_esp32_worker.h"
+#include "nhal_esp32_stats.h"
+
+#include "nhal_common.h"
+#include "nhal_uart_types.h"
+
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include <string.h>
+
+static nhal_result_t nhal_uart_tx_write_job(struct nhal_uart_context *ctx, const struct nhal_uart_tx_job *job, uint64_t *bytes) {
+    for (size_t i = 0; i < job->num_segments; i++) {
+        const struct nhal_uart_tx_segment *segment = &job->segments[i];
+        if (segment->len == 0) {
+            continue;
+        }
+        int written = uart_write_bytes(ctx->uart_bus_id, (const char *)segment->data, segment->len);
+        if (written != (int)segment->len) {
+            return NHAL_ERR_OTHER;
+        }
+        *bytes += written;
+    }
+    return NHAL_OK;
+}
+
+static void nhal_uart_tx_worker(void *arg) {
+    struct nhal_uart_tx *tx = (struct nhal_uart_tx *)arg;
+    nhal_result_t results[NHAL_ESP32_UART_TX_QUEUE_DEPTH];
+    bool stopping = false;
+
+    while (!stopping) {
+        if (xQueueReceive(tx->queue, &tx->batch[0], portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        // Everything queued meanwhile is written before the one drain wait
+        size_t count = 0;
+        uint64_t bytes = 0;
+        do {
+            if (tx->batch[count].stop) {
+                stopping = true;
+                break;
+            }
+            results[count] = nhal_uart_tx_write_job(tx->ctx, &tx->batch[count], &bytes);
+            count++;
+        } while (count < NHAL_ESP32_UART_TX_QUEUE_DEPTH &&
+                 xQueueReceive(tx->queue, &tx->batch[count], 0) == pdTRUE);
+
+        if (count == 0) {
+            continue;
+        }
+
+        nhal_result_t drained = nhal_map_esp_err(
+            uart_wait_tx_done(tx->ctx->uart_bus_id, pdMS_TO_TICKS(tx->ctx->timeout_ms))
+        );
+        uint64_t now_us = nhal_get_timestamp_microseconds();
+
+        uint32_t failed = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (results[i] == NHAL_OK) {
+                results[i] = drained;
+            }
+            if (results[i] != NHAL_OK) {
+                failed++;
+            }
+        }
+
+        portENTER_CRITICAL(&tx->lock);
+        tx->stats.completed += count;
+        tx->stats.failed += failed;
+        tx->stats.bytes += bytes;
+        tx->stats.drains++;
+        if (count > tx->stats.max_batch) {
+            tx->stats.max_batch = count;
+        }
+        portEXIT_CRITICAL(&tx->lock);
+
+        for (size_t i = 0; i < count; i++) {
+            const struct nhal_uart_tx_job *job = &tx->batch[i];
+            struct nhal_uart_tx_completion completion = {
+                .job_id = job->job_id,
+                .result = results[i],
+                .timestamp_us = now_us,
+                .user_data = job->notify.user_data,
+            };
+
+            if (job->notify.callback != NULL) {
+                job->notify.callback(tx->ctx, &completion);
+            }
+            if (job->notify.completion != NULL) {
+                *job->notify.completion = completion;
+            }
+            if (job->notify.notify_task != NULL) {
+                xTaskNotifyGive(job->notify.notify_task);
+            }
+        }
+    }
+
+    nhal_worker_exit(&tx->gate);
+}
+
+static nhal_result_t nhal_uart_tx_submit(struct nhal_uart_tx *tx, struct nhal_uart_tx_job *job,
+                                         const struct nhal_uart_tx_notify *notify, uint32_t *job_id) {
+    if (!nhal_worker_gate_enter(&tx->gate)) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (notify != NULL) {
+        job->notify = *notify;
+    }
+
+    portENTER_CRITICAL(&tx->lock);
+    job->job_id = tx->next_job_id++;
+    portEXIT_CRITICAL(&tx->lock);
+
+    if (xQueueSend(tx->queue, job, 0) != pdTRUE) {
+        nhal_worker_gate_leave(&tx->gate);
+        portENTER_CRITICAL(&tx->lock);
+        tx->stats.rejected++;
+        portEXIT_CRITICAL(&tx->lock);
+        return NHAL_ERR_BUSY;
+    }
+
+    uint32_t queued = NHAL_ESP32_UART_TX_QUEUE_DEPTH - uxQueueSpacesAvailable(tx->queue);
+    nhal_worker_gate_leave(&tx->gate);
+    portENTER_CRITICAL(&tx->lock);
+    tx->stats.submitted++;
+    if (queued > tx->stats.max_queued) {
+        tx->stats.max_queued = queued;
+    }
+    portEXIT_CRITICAL(&tx->lock);
+
+    if (job_id != NULL) {
+        *job_id = job->job_id;
+    }
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_tx_start(struct nhal_uart_tx *tx, struct nhal_uart_context *ctx) {
+    if (tx == NULL || ctx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!ctx->is_initialized) {
+        return NHAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!ctx->is_configured) {
+        return NHAL_ERR_NOT_CONFIGURED;
+    }
+
+    if (tx->is_running) {
+        return NHAL_OK;
+    }
+
+    tx->ctx = ctx;
+    tx->next_job_id = 0;
+    nhal_worker_gate_init(&tx->gate);
+    portMUX_INITIALIZE(&tx->lock);
+    memset(&tx->stats, 0, sizeof(tx->stats));
+
+    tx->queue = xQueueCreateStatic(
+        NHAL_ESP32_UART_TX_QUEUE_DEPTH,
+        sizeof(struct nhal_uart_tx_job),
+        tx->queue_storage,
+        &tx->queue_struct
+    );
+    if (tx->queue == NULL) {
+        return NHAL_ERR_OTHER;
+    }
+
+    tx->task = xTaskCreateStatic(
+        nhal_uart_tx_worker,
+        "nhal_uart_tx",
+        NHAL_ESP32_UART_TX_TASK_STACK_SIZE,
+        tx,
+        NHAL_ESP32_UART_TX_TASK_PRIORITY,
+        tx->task_stack,
+        &tx->task_struct
+    );
+    if (tx->task == NULL) {
+        vQueueDelete(tx->queue);
+        tx->queue = NULL;
+        return NHAL_ERR_OTHER;
+    }
+
+    tx->is_running = true;
+    nhal_worker_gate_open(&tx->gate);
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_tx_stop(struct nhal_uart_tx *tx) {
+    if (tx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    if (!tx->is_running) {
+        return NHAL_OK;
+    }
+
+    // Refuse new submissions, then queue the stop marker behind pending jobs
+    tx->is_running = false;
+    nhal_worker_gate_close(&tx->gate);
+
+    struct nhal_uart_tx_job stop_job = { .stop = true };
+    xQueueSend(tx->queue, &stop_job, portMAX_DELAY);
+    nhal_worker_wait_stopped(&tx->gate, tx->task);
+    tx->task = NULL;
+
+    vQueueDelete(tx->queue);
+    tx->queue = NULL;
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_tx_submit_write(
+    struct nhal_uart_tx *tx,
+    const uint8_t *data, size_t len,
+    const struct nhal_uart_tx_notify *notify,
+    uint32_t *job_id
+) {
+    if (tx == NULL || (data == NULL && len > 0)) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_uart_tx_job job = {
+        .num_segments = 1,
+        .segments = { { .data = data, .len = len } },
+    };
+    return nhal_uart_tx_submit(tx, &job, notify, job_id);
+}
+
+nhal_result_t nhal_esp32_uart_tx_submit_writev(
+    struct nhal_uart_tx *tx,
+    const struct nhal_uart_tx_segment *segments, size_t num_segments,
+    const struct nhal_uart_tx_notify *notify,
+    uint32_t *job_id
+) {
+    if (tx == NULL || segments == NULL || num_segments == 0 || num_segments > NHAL_ESP32_UART_TX_MAX_SEGMENTS) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    struct nhal_uart_tx_job job = {
+        .num_segments = num_segments,
+    };
+    for (size_t i = 0; i < num_segments; i++) {
+        if (segments[i].data == NULL && segments[i].len > 0) {
+            return NHAL_ERR_INVALID_ARG;
+        }
+        job.segments[i] = segments[i];
+    }
+    return nhal_uart_tx_submit(tx, &job, notify, job_id);
+}
+
+nhal_result_t nhal_esp32_uart_tx_get_stats(struct nhal_uart_tx *tx, struct nhal_uart_tx_stats *stats) {
+    if (tx == NULL || stats == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_copy(&tx->lock, stats, &tx->stats, sizeof(*stats));
+    return NHAL_OK;
+}
+
+nhal_result_t nhal_esp32_uart_tx_reset_stats(struct nhal_uart_tx *tx) {
+    if (tx == NULL) {
+        return NHAL_ERR_INVALID_ARG;
+    }
+
+    nhal_stats_clear(&tx->lock, &tx->stats, sizeof(tx->stats));
+    return NHAL_OK;
+}
@@ -0,0 +1,73 @@
+#include "nhal_esp32_worker.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+void nhal_worker_gate_init(struct nhal_worker_gate *gate) {
+    portMUX_INITIALIZE(&gate->lock);
+    gate->open = false;
+    gate->inside = 0;
+    gate->stopped = xSemaphoreCreateBinaryStatic(&gate->stopped_struct);
+}
+
+void nhal_worker_gate_open(struct nhal_worker_gate *gate) {
+    portENTER_CRITICAL(&gate->lock);
+    gate->open = true;
+    portEXIT_CRITICAL(&gate->lock);
+}
+
+bool nhal_worker_gate_enter(struct nhal_worker_gate *gate) {
+    bool admitted;
+    portENTER_CRITICAL(&gate->lock);
+    admitted = gate->open;
+    if (admitted) {
+        gate->inside++;
+    }
+    portEXIT_CRITICAL(&gate->lock);
+    return admitted;
+}
+
+void nhal_worker_gate_leave(struct nhal_worker_gate *gate) {
+    portENTER_CRITICAL(&gate->lock);
+    gate->inside--;
+    portEXIT_CRITICAL(&gate->lock);
+}
+
+void nhal_worker_gate_close(struct nhal_worker_gate *gate) {
+    portENTER_CRITICAL(&gate->lock);
+    gate->open = false;
+    portEXIT_CRITICAL(&gate->lock);
+
+    // Submitters never block while inside, so this is a short wait
+    for (;;) {
+        portENTER_CRITICAL(&gate->lock);
+        uint32_t inside = gate->inside;
+        portEXIT_CRITICAL(&gate->lock);
+        if (inside == 0) {
+            return;
+        }
+        vTaskDelay(1);
+    }
+}
+
+void nhal_worker_exit(struct nhal_worker_gate *gate) {
+    xSemaphoreGive(gate->stopped);
+
+    // Deleting itself would leave the TCB to the idle task, after the
+    // stopper may already have reused it; the stopper deletes us instead
+    for (;;) {
+        vTaskSuspend(NULL);
+    }
+}
+
+void nhal_worker_wait_stopped(struct nhal_worker_gate *gate, TaskHandle_t worker) {
+    xSemaphoreTake(gate->stopped, portMAX_DELAY);
+
+    // Suspended means no core is still running it, so the kernel drops it
+    // from its lists right here and never touches its memory again
+    while (eTaskGetState(worker) != eSuspended) {
+        vTaskDelay(1);
+    }
+    vTaskDelete(worker);
+}